@@ -0,0 +1,58 @@
+#!/bin/sh
+# LiteVCS save benchmark
+#
+# Times `vcs save` for each durability mode (config key "durability") and
+# I/O backend (config key "io"): a first save that writes every blob, then
+# a save after touching every file.
+#
+# Usage: bench/bench_save.sh [path/to/vcs] [file_count]
+
+VCS=$(cd "$(dirname "${1:-./vcs}")" && pwd)/$(basename "${1:-./vcs}")
+FILES=${2:-1000}
+
+if [ ! -x "$VCS" ]; then
+    echo "vcs binary not found: $VCS"
+    exit 1
+fi
+
+now_ms() {
+    echo $(( $(date +%s%N) / 1000000 ))
+}
+
+printf "%-8s %-8s %10s %12s %12s\n" "mode" "io" "files" "first_ms" "update_ms"
+
+for mode in none batch full; do
+for io in uring threads; do
+    dir=$(mktemp -d "${TMPDIR:-/tmp}/litevcs-bench.XXXXXX")
+    (
+        cd "$dir" || exit 1
+        "$VCS" init > /dev/null
+        printf "version=1\ndurability=%s\nio=%s\n" "$mode" "$io" > .vcs/config
+
+        mkdir -p src
+        i=0
+        while [ $i -lt "$FILES" ]; do
+            echo "file $i" > "src/f$i.txt"
+            echo "src/f$i.txt" >> .vcs/index
+            i=$((i + 1))
+        done
+
+        start=$(now_ms)
+        "$VCS" save "first" > /dev/null
+        first=$(( $(now_ms) - start ))
+
+        i=0
+        while [ $i -lt "$FILES" ]; do
+            echo "change" >> "src/f$i.txt"
+            i=$((i + 1))
+        done
+
+        start=$(now_ms)
+        "$VCS" save "update" > /dev/null
+        update=$(( $(now_ms) - start ))
+
+        printf "%-8s %-8s %10s %12s %12s\n" "$mode" "$io" "$FILES" "$first" "$update"
+    )
+    rm -rf "$dir"
+done
+done
@@ -0,0 +1,535 @@
+/**
+ * LiteVCS Batched File I/O Implementation
+ *
+ * The io_uring backend talks to the kernel through the raw syscalls and
+ * the ring layout from <linux/io_uring.h>, so no extra library is needed.
+ * open/fstat/close stay synchronous (they hit the dentry cache); the data
+ * transfers and fsyncs are what get queued, up to QUEUE_DEPTH at a time.
+ *
+ * @author Puneeth R (GHOST)
+ * @license MIT
+ */
+
+#include "batchio.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define LITEVCS_POSIX_IO 1
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define LITEVCS_HAVE_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+#endif
+
+namespace batchio {
+
+namespace {
+
+#ifdef LITEVCS_POSIX_IO
+
+    bool readWhole(const std::string& path, std::string& data) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0)
+            data.reserve(static_cast<size_t>(st.st_size));
+
+        char chunk[64 * 1024];
+        while (true) {
+            ssize_t n = ::read(fd, chunk, sizeof(chunk));
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0) {
+                ::close(fd);
+                return false;
+            }
+            if (n == 0) break;
+            data.append(chunk, static_cast<size_t>(n));
+        }
+        ::close(fd);
+        return true;
+    }
+
+    int writeWhole(const WriteRequest& req) {
+        int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (req.exclusive ? O_EXCL : O_TRUNC);
+        int fd = ::open(req.path.c_str(), flags, 0644);
+        if (fd < 0) return errno;
+
+        size_t written = 0;
+        while (written < req.data.size()) {
+            ssize_t n = ::write(fd, req.data.data() + written, req.data.size() - written);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                int err = errno;
+                ::close(fd);
+                return err;
+            }
+            written += static_cast<size_t>(n);
+        }
+
+#if defined(__APPLE__)
+        if (req.sync && ::fsync(fd) < 0) {
+#else
+        if (req.sync && ::fdatasync(fd) < 0) {
+#endif
+            int err = errno;
+            ::close(fd);
+            return err;
+        }
+        return ::close(fd) < 0 ? errno : 0;
+    }
+
+#else
+
+    bool readWhole(const std::string& path, std::string& data) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) return false;
+        std::ostringstream ss;
+        ss << in.rdbuf();
+        data = ss.str();
+        return true;
+    }
+
+    int writeWhole(const WriteRequest& req) {
+        std::ofstream out(req.path, std::ios::binary | std::ios::trunc);
+        out.write(req.data.data(), req.data.size());
+        out.close();
+        return out ? 0 : EIO;
+    }
+
+#endif
+
+    /**
+     * Portable backend: blocking calls spread over a thread pool
+     */
+    class ThreadedIO : public BatchIO {
+    public:
+        // I/O-bound, so oversubscribe the CPUs to keep the device queue busy
+        ThreadedIO()
+            : pool(std::clamp<size_t>(std::thread::hardware_concurrency() * 2, 4, 32)) {}
+
+        const char* name() const override { return "threads"; }
+
+        void readFiles(const std::vector<std::string>& paths,
+                       const ReadCallback& onRead) override {
+            for (size_t i = 0; i < paths.size(); ++i) {
+                pool.submit([&paths, &onRead, i] {
+                    std::string data;
+                    bool ok = readWhole(paths[i], data);
+                    onRead(i, std::move(data), ok);
+                });
+            }
+            pool.wait();
+        }
+
+        std::vector<int> writeFiles(const std::vector<WriteRequest>& requests) override {
+            std::vector<int> results(requests.size(), 0);
+            for (size_t i = 0; i < requests.size(); ++i) {
+                pool.submit([&requests, &results, i] {
+                    results[i] = writeWhole(requests[i]);
+                });
+            }
+            pool.wait();
+            return results;
+        }
+
+    private:
+        ThreadPool pool;
+    };
+
+#ifdef LITEVCS_HAVE_IO_URING
+
+    // Requests kept in flight at once
+    const unsigned QUEUE_DEPTH = 64;
+
+    // Finished reads waiting for a worker; past this the ring stops reading
+    // until the callbacks catch up
+    const size_t DELIVERY_BYTES = 64 * 1024 * 1024;
+
+    /**
+     * Minimal io_uring submission/completion ring
+     */
+    class Ring {
+    public:
+        ~Ring() {
+            if (sqes) ::munmap(sqes, sqesSize);
+            if (cqRing && cqRing != sqRing) ::munmap(cqRing, cqRingSize);
+            if (sqRing) ::munmap(sqRing, sqRingSize);
+            if (fd >= 0) ::close(fd);
+        }
+
+        bool init(unsigned depth) {
+            io_uring_params p;
+            std::memset(&p, 0, sizeof(p));
+
+            fd = static_cast<int>(::syscall(__NR_io_uring_setup, depth, &p));
+            if (fd < 0) return false;
+
+            sqRingSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+            cqRingSize = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+            bool single = p.features & IORING_FEAT_SINGLE_MMAP;
+            if (single) sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+
+            sqRing = map(sqRingSize, IORING_OFF_SQ_RING);
+            if (!sqRing) return false;
+            cqRing = single ? sqRing : map(cqRingSize, IORING_OFF_CQ_RING);
+            if (!cqRing) return false;
+
+            sqesSize = p.sq_entries * sizeof(io_uring_sqe);
+            sqes = static_cast<io_uring_sqe*>(map(sqesSize, IORING_OFF_SQES));
+            if (!sqes) return false;
+
+            char* sq = static_cast<char*>(sqRing);
+            sqHead = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+            sqTail = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+            sqMask = reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+            sqArray = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+            sqEntries = p.sq_entries;
+
+            char* cq = static_cast<char*>(cqRing);
+            cqHead = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+            cqTail = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+            cqMask = reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+            cqes = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+
+            localTail = *sqTail;
+            return true;
+        }
+
+        /**
+         * Reserve and zero the next submission entry
+         * @return nullptr if the submission queue is full
+         */
+        io_uring_sqe* next() {
+            unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+            if (localTail - head >= sqEntries) return nullptr;
+
+            unsigned idx = localTail & *sqMask;
+            sqArray[idx] = idx;
+            io_uring_sqe* sqe = &sqes[idx];
+            std::memset(sqe, 0, sizeof(*sqe));
+
+            localTail++;
+            pending++;
+            return sqe;
+        }
+
+        /**
+         * Submit queued entries and wait for at least one completion
+         * @return 0, or a negative errno
+         */
+        int submitAndWait() {
+            __atomic_store_n(sqTail, localTail, __ATOMIC_RELEASE);
+
+            long r = ::syscall(__NR_io_uring_enter, fd, pending, 1,
+                               IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (r < 0) return -errno;
+            pending -= static_cast<unsigned>(r);
+            return 0;
+        }
+
+        template <typename F>
+        void reap(F handle) {
+            unsigned head = *cqHead;
+            unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+
+            while (head != tail) {
+                const io_uring_cqe& cqe = cqes[head & *cqMask];
+                uint64_t userData = cqe.user_data;
+                int res = cqe.res;
+                head++;
+                // Release the slot before handling; the handler may queue more
+                __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+                handle(userData, res);
+            }
+        }
+
+    private:
+        int fd = -1;
+        void* sqRing = nullptr;
+        void* cqRing = nullptr;
+        size_t sqRingSize = 0;
+        size_t cqRingSize = 0;
+        size_t sqesSize = 0;
+
+        unsigned* sqHead = nullptr;
+        unsigned* sqTail = nullptr;
+        unsigned* sqMask = nullptr;
+        unsigned* sqArray = nullptr;
+        unsigned sqEntries = 0;
+        io_uring_sqe* sqes = nullptr;
+
+        unsigned* cqHead = nullptr;
+        unsigned* cqTail = nullptr;
+        unsigned* cqMask = nullptr;
+        io_uring_cqe* cqes = nullptr;
+
+        unsigned localTail = 0;
+        unsigned pending = 0;
+
+        void* map(size_t size, off_t offset) {
+            void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE, fd, offset);
+            return p == MAP_FAILED ? nullptr : p;
+        }
+    };
+
+    /**
+     * io_uring backend
+     */
+    class UringIO : public BatchIO {
+    public:
+        bool init() {
+            return ring.init(QUEUE_DEPTH);
+        }
+
+        const char* name() const override { return "io_uring"; }
+
+        void readFiles(const std::vector<std::string>& paths,
+                       const ReadCallback& onRead) override {
+            struct Job {
+                size_t index;
+                int fd;
+                std::string buffer;
+                size_t done;
+                iovec iov;
+            };
+
+            std::vector<std::unique_ptr<Job>> jobs(paths.size());
+            size_t next = 0;
+            size_t inflight = 0;
+
+            std::mutex queuedMutex;
+            std::condition_variable drained;
+            size_t queuedBytes = 0;
+
+            // Hand finished data to the workers while more reads are in flight,
+            // waiting first if too much is already queued for them
+            auto deliver = [&](size_t i, std::string data, bool ok) {
+                size_t bytes = data.size();
+                {
+                    std::unique_lock<std::mutex> lock(queuedMutex);
+                    drained.wait(lock, [&] {
+                        return queuedBytes == 0 || queuedBytes + bytes <= DELIVERY_BYTES;
+                    });
+                    queuedBytes += bytes;
+                }
+
+                workers.submit([&, i, bytes, data = std::move(data), ok]() mutable {
+                    struct Release {
+                        std::mutex& mutex;
+                        std::condition_variable& drained;
+                        size_t& queued;
+                        size_t bytes;
+                        ~Release() {
+                            std::lock_guard<std::mutex> lock(mutex);
+                            queued -= bytes;
+                            drained.notify_one();
+                        }
+                    } release{ queuedMutex, drained, queuedBytes, bytes };
+
+                    std::string owned = std::move(data);
+                    onRead(i, std::move(owned), ok);
+                });
+            };
+
+            auto queueRead = [&](Job& job) {
+                io_uring_sqe* sqe = ring.next();
+                job.iov.iov_base = &job.buffer[job.done];
+                job.iov.iov_len = job.buffer.size() - job.done;
+                sqe->opcode = IORING_OP_READV;
+                sqe->fd = job.fd;
+                sqe->addr = reinterpret_cast<uint64_t>(&job.iov);
+                sqe->len = 1;
+                sqe->off = job.done;
+                sqe->user_data = job.index;
+            };
+
+            auto finish = [&](size_t i, bool ok) {
+                Job& job = *jobs[i];
+                ::close(job.fd);
+                if (ok) job.buffer.resize(job.done);
+                deliver(i, ok ? std::move(job.buffer) : std::string(), ok);
+                jobs[i].reset();
+                inflight--;
+            };
+
+            try {
+                while (next < paths.size() || inflight > 0) {
+                    while (inflight < QUEUE_DEPTH && next < paths.size()) {
+                        size_t i = next++;
+                        int fd = ::open(paths[i].c_str(), O_RDONLY | O_CLOEXEC);
+                        if (fd < 0) {
+                            deliver(i, std::string(), false);
+                            continue;
+                        }
+
+                        struct stat st;
+                        if (::fstat(fd, &st) < 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+                            // Empty or special file: plain read, nothing to queue
+                            ::close(fd);
+                            std::string data;
+                            bool ok = readWhole(paths[i], data);
+                            deliver(i, std::move(data), ok);
+                            continue;
+                        }
+
+                        jobs[i] = std::make_unique<Job>(
+                            Job{ i, fd, std::string(static_cast<size_t>(st.st_size), '\0'), 0, {} });
+                        queueRead(*jobs[i]);
+                        inflight++;
+                    }
+                    if (inflight == 0) break;
+
+                    int r = ring.submitAndWait();
+                    if (r < 0 && r != -EINTR && r != -EAGAIN && r != -EBUSY)
+                        throw std::runtime_error(std::string("io_uring_enter: ") + std::strerror(-r));
+
+                    ring.reap([&](uint64_t i, int res) {
+                        Job& job = *jobs[i];
+                        if (res == -EINTR || res == -EAGAIN) {
+                            queueRead(job);
+                        } else if (res < 0) {
+                            finish(i, false);
+                        } else {
+                            job.done += static_cast<size_t>(res);
+                            // Short read: continue where it stopped, unless at EOF
+                            if (res > 0 && job.done < job.buffer.size()) queueRead(job);
+                            else finish(i, true);
+                        }
+                    });
+                }
+            } catch (...) {
+                for (auto& job : jobs)
+                    if (job) ::close(job->fd);
+                workers.wait();
+                throw;
+            }
+
+            workers.wait();
+        }
+
+        std::vector<int> writeFiles(const std::vector<WriteRequest>& requests) override {
+            struct Job {
+                int fd;
+                size_t done;
+                bool syncing;
+                iovec iov;
+            };
+
+            std::vector<int> results(requests.size(), 0);
+            std::vector<Job> jobs(requests.size());
+            size_t next = 0;
+            size_t inflight = 0;
+
+            auto queueWrite = [&](size_t i) {
+                Job& job = jobs[i];
+                const std::string& data = requests[i].data;
+                io_uring_sqe* sqe = ring.next();
+                job.iov.iov_base = const_cast<char*>(data.data() + job.done);
+                job.iov.iov_len = data.size() - job.done;
+                sqe->opcode = IORING_OP_WRITEV;
+                sqe->fd = job.fd;
+                sqe->addr = reinterpret_cast<uint64_t>(&job.iov);
+                sqe->len = 1;
+                sqe->off = job.done;
+                sqe->user_data = i;
+            };
+
+            auto queueSync = [&](size_t i) {
+                io_uring_sqe* sqe = ring.next();
+                jobs[i].syncing = true;
+                sqe->opcode = IORING_OP_FSYNC;
+                sqe->fd = jobs[i].fd;
+                sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+                sqe->user_data = i;
+            };
+
+            auto finish = [&](size_t i, int err) {
+                if (::close(jobs[i].fd) < 0 && err == 0) err = errno;
+                results[i] = err;
+                inflight--;
+            };
+
+            while (next < requests.size() || inflight > 0) {
+                while (inflight < QUEUE_DEPTH && next < requests.size()) {
+                    size_t i = next++;
+                    const WriteRequest& req = requests[i];
+
+                    int flags = O_WRONLY | O_CREAT | O_CLOEXEC |
+                                (req.exclusive ? O_EXCL : O_TRUNC);
+                    int fd = ::open(req.path.c_str(), flags, 0644);
+                    if (fd < 0) {
+                        results[i] = errno;
+                        continue;
+                    }
+
+                    jobs[i] = { fd, 0, false, {} };
+                    inflight++;
+                    if (!req.data.empty()) queueWrite(i);
+                    else if (req.sync) queueSync(i);
+                    else finish(i, 0);
+                }
+                if (inflight == 0) break;
+
+                int r = ring.submitAndWait();
+                if (r < 0 && r != -EINTR && r != -EAGAIN && r != -EBUSY)
+                    throw std::runtime_error(std::string("io_uring_enter: ") + std::strerror(-r));
+
+                ring.reap([&](uint64_t i, int res) {
+                    Job& job = jobs[i];
+                    if (res == -EINTR || res == -EAGAIN) {
+                        if (job.syncing) queueSync(i);
+                        else queueWrite(i);
+                    } else if (res < 0) {
+                        finish(i, -res);
+                    } else if (job.syncing) {
+                        finish(i, 0);
+                    } else {
+                        job.done += static_cast<size_t>(res);
+                        if (res > 0 && job.done < requests[i].data.size()) queueWrite(i);
+                        else if (res == 0 && job.done < requests[i].data.size()) finish(i, EIO);
+                        else if (requests[i].sync) queueSync(i);
+                        else finish(i, 0);
+                    }
+                });
+            }
+            return results;
+        }
+
+    private:
+        Ring ring;
+        ThreadPool workers;
+    };
+
+#endif
+}
+
+std::unique_ptr<BatchIO> create(const std::string& mode) {
+#ifdef LITEVCS_HAVE_IO_URING
+    if (mode != "threads") {
+        auto uring = std::make_unique<UringIO>();
+        if (uring->init()) return uring;
+    }
+#endif
+    return std::make_unique<ThreadedIO>();
+}
+
+}
@@ -0,0 +1,63 @@
+/**
+ * LiteVCS Batched File I/O
+ *
+ * Bulk whole-file reads and writes for save, checkout and diff. The
+ * io_uring backend keeps many requests in flight from a single thread and
+ * hands finished reads to worker threads, so hashing, compression and
+ * inflation overlap with outstanding I/O. Where io_uring is unavailable
+ * (other platforms, old kernels, seccomp) a thread pool does the same job
+ * with blocking calls.
+ *
+ * @author Puneeth R (GHOST)
+ * @license MIT
+ */
+
+#pragma once
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace batchio {
+
+    /**
+     * Receives each file's content as soon as it has been read
+     * May be called concurrently from several threads, in any order.
+     * @param ok false if the file could not be opened or read
+     */
+    using ReadCallback =
+        std::function<void(size_t index, std::string&& data, bool ok)>;
+
+    struct WriteRequest {
+        std::string path;
+        std::string data;
+        bool exclusive = false;     // create a fresh file (O_EXCL) instead of truncating
+        bool sync = false;          // fdatasync once written
+    };
+
+    class BatchIO {
+    public:
+        virtual ~BatchIO() = default;
+
+        virtual const char* name() const = 0;
+
+        /**
+         * Read every file; returns once all callbacks have finished
+         * Rethrows the first exception thrown by a callback.
+         */
+        virtual void readFiles(const std::vector<std::string>& paths,
+                               const ReadCallback& onRead) = 0;
+
+        /**
+         * Write every file
+         * @return errno per request (0 on success)
+         */
+        virtual std::vector<int> writeFiles(const std::vector<WriteRequest>& requests) = 0;
+    };
+
+    /**
+     * Pick a backend
+     * @param mode "uring", "threads", or "auto"/"" (io_uring when the kernel allows it)
+     */
+    std::unique_ptr<BatchIO> create(const std::string& mode);
+}
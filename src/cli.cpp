@@ -9,6 +9,7 @@
 
 #include "cli.h"
 #include "repository.h"
+#include "server.h"
 #include <iostream>
 #include <filesystem>
 
@@ -21,15 +22,24 @@ void CLI::handle(const std::vector<std::string>& args) {
         std::cout << "Usage: vcs <command>\n";
         std::cout << "\nAvailable commands:\n";
         std::cout << "  init                     - Initialize a new repository\n";
+        std::cout << "  clone <src> <dst>        - Clone sharing objects (--no-hardlinks to copy)\n";
         std::cout << "  track <file>             - Track a file\n";
         std::cout << "  save \"message\"           - Commit changes\n";
         std::cout << "  history                  - Show commit history\n";
         std::cout << "  go <commit_hash>         - Checkout a commit\n";
+        std::cout << "  go <hash> -- <paths...>  - Sparse checkout of matching paths/globs\n";
         std::cout << "  diff [options]           - Show changes\n";
+        std::cout << "  status                   - List changed tracked files\n";
+        std::cout << "  watch [stop]             - Run/stop the filesystem watcher\n";
+        std::cout << "  serve [socket]           - Answer JSON requests on a Unix socket\n";
+        std::cout << "  gc [--prune=<days>|now]  - Pack reachable objects, prune the rest\n";
         std::cout << "\nDiff options:\n";
         std::cout << "  --smart                  - Smart/semantic diff\n";
         std::cout << "  --ignore-empty           - Ignore empty lines\n";
         std::cout << "  --ignore-whitespace      - Ignore whitespace\n";
+        std::cout << "  -M[<n>]                  - Detect renames (n% similar, default 50)\n";
+        std::cout << "  -C[<n>]                  - Detect copies of changed files, and renames\n";
+        std::cout << "  --find-copies-harder     - With -C, copy from any file (reads every blob)\n";
         return;
     }
 
@@ -39,6 +49,20 @@ void CLI::handle(const std::vector<std::string>& args) {
         if (args[1] == "init") {
             repo.init();
         }
+        else if (args[1] == "clone") {
+            std::vector<std::string> paths;
+            bool hardlinks = true;
+            for (size_t i = 2; i < args.size(); ++i) {
+                if (args[i] == "--no-hardlinks") hardlinks = false;
+                else paths.push_back(args[i]);
+            }
+            if (paths.size() != 2) {
+                std::cout << "Usage: vcs clone <src> <dst> [--no-hardlinks]\n";
+                return;
+            }
+            Repository source(paths[0]);
+            source.cloneTo(paths[1], hardlinks);
+        }
         else if (args[1] == "track") {
             if (args.size() < 3) {
                 std::cout << "Usage: vcs track <file>\n";
@@ -58,7 +82,7 @@ void CLI::handle(const std::vector<std::string>& args) {
         }
         else if (args[1] == "go") {
             if (args.size() < 3) {
-                std::cout << "Usage: vcs go <commit_hash>\n";
+                std::cout << "Usage: vcs go <commit_hash> [-- <paths/globs>...]\n";
                 return;
             }
             // Security: Validate commit hash length (SHA-1 is 40 hex characters)
@@ -73,24 +97,95 @@ void CLI::handle(const std::vector<std::string>& args) {
                     return;
                 }
             }
-            repo.goToCommit(args[2]);
+            if (args.size() >= 4 && args[3] == "--") {
+                // "go <hash> --" with no patterns returns to a full checkout
+                std::vector<std::string> patterns(args.begin() + 4, args.end());
+                repo.goToCommit(args[2], patterns);
+            } else {
+                if (args.size() > 3)
+                    std::cout << "Warning: ignoring extra arguments (use -- before paths)\n";
+                repo.goToCommit(args[2]);
+            }
         }
         else if (args[1] == "diff") {
             bool smart = false, ignoreEmpty = false, ignoreWhitespace = false;
+            RenameOptions renames;
 
             for (size_t i = 2; i < args.size(); ++i) {
                 if (args[i] == "--smart") smart = true;
                 else if (args[i] == "--ignore-empty") ignoreEmpty = true;
                 else if (args[i] == "--ignore-whitespace") ignoreWhitespace = true;
+                else if (args[i] == "--find-copies-harder") renames.copiesHarder = true;
+                else if (args[i].rfind("-M", 0) == 0 || args[i].rfind("-C", 0) == 0) {
+                    // -M / -C, optionally followed by a threshold: -M60 or -M60%
+                    std::string value = args[i].substr(2);
+                    if (!value.empty() && value.back() == '%') value.pop_back();
+
+                    bool valid = !value.empty() && value.size() <= 3;
+                    for (char c : value) {
+                        if (!isdigit(static_cast<unsigned char>(c))) valid = false;
+                    }
+                    if (!value.empty() && (!valid || std::stoi(value) > 100)) {
+                        std::cout << "Error: similarity threshold must be 0-100\n";
+                        return;
+                    }
+                    if (!value.empty()) renames.threshold = std::stoi(value);
+
+                    renames.detectRenames = true;
+                    if (args[i][1] == 'C') renames.detectCopies = true;
+                }
                 else {
                     std::cout << "Warning: unknown option " << args[i] << "\n";
                 }
             }
+            if (renames.copiesHarder && !renames.detectCopies) {
+                std::cout << "Error: --find-copies-harder needs -C\n";
+                return;
+            }
 
             if (smart)
                 repo.diffSmart(ignoreEmpty, ignoreWhitespace);
             else
-                repo.diff(ignoreEmpty, ignoreWhitespace);
+                repo.diff(ignoreEmpty, ignoreWhitespace, renames);
+        }
+        else if (args[1] == "status") {
+            repo.status();
+        }
+        else if (args[1] == "watch") {
+            if (args.size() >= 3 && args[2] == "stop")
+                repo.stopWatch();
+            else
+                repo.watch();
+        }
+        else if (args[1] == "serve") {
+            std::string socketPath = args.size() >= 3
+                ? args[2]
+                : repo.rootPath() + "/.vcs/serve.sock";
+            server::run(repo, socketPath);
+        }
+        else if (args[1] == "gc") {
+            // Unreachable objects younger than the grace period are kept
+            std::time_t grace = 14 * 24 * 60 * 60;
+
+            for (size_t i = 2; i < args.size(); ++i) {
+                if (args[i].rfind("--prune=", 0) == 0) {
+                    std::string value = args[i].substr(8);
+                    bool valid = !value.empty() && value.size() <= 5;
+                    for (char c : value) {
+                        if (!isdigit(static_cast<unsigned char>(c))) valid = false;
+                    }
+                    if (value == "now") grace = 0;
+                    else if (valid) grace = static_cast<std::time_t>(std::stoi(value)) * 24 * 60 * 60;
+                    else {
+                        std::cout << "Error: --prune takes a number of days or 'now'\n";
+                        return;
+                    }
+                }
+                else {
+                    std::cout << "Warning: unknown option " << args[i] << "\n";
+                }
+            }
+            repo.gc(grace);
         }
         else {
             std::cout << "Unknown command: " << args[1] << "\n";
@@ -0,0 +1,280 @@
+/**
+ * LiteVCS Local Clone
+ *
+ * Objects are content-addressed and never modified in place (every write
+ * goes to a temp file that is renamed over the target), so a clone can
+ * share the source's object files instead of copying them. Each object is
+ * hardlinked when possible; otherwise it is reflinked (FICLONE), copied with
+ * copy_file_range, or copied through userspace, in that order. The working
+ * tree is then written by a regular parallel checkout.
+ *
+ * @author Puneeth R (GHOST)
+ * @license MIT
+ */
+
+#include "repository.h"
+#include "utils.h"
+#include "transaction.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define LITEVCS_POSIX_IO 1
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#endif
+
+namespace {
+
+    enum class Shared { Hardlink, Reflink, Copy };
+
+    std::atomic<unsigned long> tempCounter{ 0 };
+
+#ifdef LITEVCS_POSIX_IO
+
+    [[noreturn]] void fail(const std::string& what, const std::string& path) {
+        throw std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+    }
+
+    void copyData(int in, int out, const std::string& path) {
+#ifdef __linux__
+        // In-kernel copy; filesystems that support it may share extents
+        bool first = true;
+        while (true) {
+            ssize_t n = ::copy_file_range(in, nullptr, out, nullptr, 1 << 30, 0);
+            if (n == 0) return;
+            if (n > 0) {
+                first = false;
+                continue;
+            }
+            if (errno == EINTR) continue;
+            if (!first || (errno != EXDEV && errno != ENOSYS && errno != EINVAL &&
+                           errno != EOPNOTSUPP && errno != EPERM)) {
+                fail("copy failed for", path);
+            }
+            break;
+        }
+#endif
+        char buffer[1 << 16];
+        while (true) {
+            ssize_t n = ::read(in, buffer, sizeof(buffer));
+            if (n == 0) return;
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                fail("read failed for", path);
+            }
+            for (ssize_t done = 0; done < n;) {
+                ssize_t w = ::write(out, buffer + done, static_cast<size_t>(n - done));
+                if (w < 0) {
+                    if (errno == EINTR) continue;
+                    fail("write failed for", path);
+                }
+                done += w;
+            }
+        }
+    }
+
+    /**
+     * Give `to` the content of `from`, sharing storage where the filesystem allows
+     * Copies go through a temp file so a crash never leaves a partial object.
+     */
+    Shared shareFile(const std::string& from, const std::string& to,
+                     bool hardlinks, bool sync) {
+        if (hardlinks && ::link(from.c_str(), to.c_str()) == 0) return Shared::Hardlink;
+
+        std::string temp = to + ".tmp-" + std::to_string(static_cast<long>(::getpid())) +
+                           "-" + std::to_string(tempCounter++);
+
+        int in = ::open(from.c_str(), O_RDONLY | O_CLOEXEC);
+        if (in < 0) fail("cannot open", from);
+        int out = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        if (out < 0) {
+            int saved = errno;
+            ::close(in);
+            errno = saved;
+            fail("cannot create", temp);
+        }
+
+        Shared how = Shared::Copy;
+        try {
+#ifdef FICLONE
+            if (::ioctl(out, FICLONE, in) == 0) how = Shared::Reflink;
+            else
+#endif
+            copyData(in, out, from);
+
+            if (sync && ::fsync(out) < 0) fail("sync failed for", temp);
+        } catch (...) {
+            ::close(in);
+            ::close(out);
+            ::unlink(temp.c_str());
+            throw;
+        }
+        ::close(in);
+        if (::close(out) < 0 || ::rename(temp.c_str(), to.c_str()) < 0) {
+            int saved = errno;
+            ::unlink(temp.c_str());
+            errno = saved;
+            fail("cannot store", to);
+        }
+        return how;
+    }
+
+    void syncDirectory(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) fail("cannot open", path);
+        int res = ::fsync(fd);
+        int saved = errno;
+        ::close(fd);
+        if (res < 0) {
+            errno = saved;
+            fail("sync failed for", path);
+        }
+    }
+
+#else
+
+    Shared shareFile(const std::string& from, const std::string& to, bool hardlinks, bool) {
+        std::error_code ec;
+        if (hardlinks) {
+            std::filesystem::create_hard_link(from, to, ec);
+            if (!ec) return Shared::Hardlink;
+        }
+
+        std::string temp = to + ".tmp-0-" + std::to_string(tempCounter++);
+        std::filesystem::copy_file(from, temp, ec);
+        if (!ec) std::filesystem::rename(temp, to, ec);
+        if (ec) {
+            std::filesystem::remove(temp);
+            throw std::runtime_error("cannot copy " + from + ": " + ec.message());
+        }
+        return Shared::Copy;
+    }
+
+    void syncDirectory(const std::string&) {}
+
+#endif
+
+    std::string elapsed(std::chrono::steady_clock::time_point start) {
+        std::ostringstream s;
+        s.setf(std::ios::fixed);
+        s.precision(1);
+        s << std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count() << " ms";
+        return s.str();
+    }
+}
+
+/**
+ * Create a new repository at destination that shares this one's objects
+ * @param destination Directory to create (may exist if empty)
+ * @param hardlinks false to never hardlink, e.g. when sandboxes must not
+ *                  be able to write through to the source's object files
+ * @return true if the clone was created and checked out
+ */
+bool Repository::cloneTo(const std::string& destination, bool hardlinks) {
+    if (!isInitialized()) {
+        *out << "Error: not a LiteVCS repository.\n";
+        return false;
+    }
+
+    std::error_code ec;
+    bool created = !std::filesystem::exists(destination, ec);
+    if (!created && (!std::filesystem::is_directory(destination, ec) ||
+                     !std::filesystem::is_empty(destination, ec))) {
+        *out << "Error: destination already exists and is not empty\n";
+        return false;
+    }
+
+    std::string destVcs = destination + "/.vcs";
+    std::string head = utils::read_file(vcsDir + "/HEAD");
+    size_t counts[3] = { 0, 0, 0 };     // indexed by Shared
+
+    try {
+        auto start = std::chrono::steady_clock::now();
+
+        for (const char* dir : { "blobs", "trees", "commits", "pack" })
+            utils::create_dir(destVcs + "/objects/" + dir);
+
+        // Repository metadata is small and mutable: always copied
+        for (const char* file : { "index", "config", "sparse-checkout" }) {
+            if (utils::exists(vcsDir + "/" + file))
+                std::filesystem::copy_file(vcsDir + "/" + file, destVcs + "/" + file);
+        }
+        if (std::filesystem::is_directory(vcsDir + "/refs", ec))
+            std::filesystem::copy(vcsDir + "/refs", destVcs + "/refs",
+                                  std::filesystem::copy_options::recursive);
+        std::ofstream(destVcs + "/HEAD") << "null";
+
+        Repository target(destination, *out);
+        txn::Durability durability =
+            txn::parseDurability(target.configValue("durability"));
+        bool sync = durability != txn::Durability::None;
+
+        std::vector<std::pair<std::string, std::string>> objects;
+        for (const char* dir : { "blobs", "trees", "commits", "pack" }) {
+            std::string from = vcsDir + "/objects/" + dir;
+            if (!std::filesystem::is_directory(from, ec)) continue;
+
+            for (const auto& entry : std::filesystem::directory_iterator(from)) {
+                std::string name = entry.path().filename().string();
+                if (name.find(".tmp-") != std::string::npos) continue;
+                objects.emplace_back(entry.path().string(),
+                                     destVcs + "/objects/" + dir + "/" + name);
+            }
+        }
+
+        // Link syscalls are cheap but numerous; keep many in flight
+        {
+            std::atomic<size_t> shared[3] = { {0}, {0}, {0} };
+            ThreadPool pool(std::clamp<size_t>(std::thread::hardware_concurrency() * 2, 4, 32));
+            for (const auto& [from, to] : objects) {
+                pool.submit([&, from = from, to = to] {
+                    shared[static_cast<int>(shareFile(from, to, hardlinks, sync))]++;
+                });
+            }
+            pool.wait();
+            for (int i = 0; i < 3; ++i) counts[i] = shared[i];
+        }
+
+        if (sync) {
+            for (const char* dir : { "blobs", "trees", "commits", "pack" })
+                syncDirectory(destVcs + "/objects/" + dir);
+        }
+
+        *out << "Shared " << objects.size() << " object files: "
+             << counts[static_cast<int>(Shared::Hardlink)] << " hardlinked, "
+             << counts[static_cast<int>(Shared::Reflink)] << " reflinked, "
+             << counts[static_cast<int>(Shared::Copy)] << " copied ("
+             << elapsed(start) << ")\n";
+
+        // Populate the working tree with the usual parallel (and sparse-aware) checkout
+        if (head != "null" && !head.empty()) {
+            start = std::chrono::steady_clock::now();
+            if (!target.checkout(head, nullptr))
+                throw std::runtime_error("checkout of " + head.substr(0, 8) + " failed");
+            *out << "Checked out working tree (" << elapsed(start) << ")\n";
+        }
+    } catch (const std::exception& e) {
+        *out << "Error: clone failed - " << e.what() << "\n";
+        std::filesystem::remove_all(created ? destination : destVcs, ec);
+        return false;
+    }
+
+    *out << "Cloned into " << destination << "\n";
+    return true;
+}
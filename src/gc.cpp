@@ -0,0 +1,303 @@
+/**
+ * LiteVCS Garbage Collection
+ *
+ * gc runs in three phases:
+ *   mark   walk the commit chains from HEAD and .vcs/refs (save and go
+ *          keep every branch tip under refs/tips); trees are parsed on a
+ *          thread pool while the walk continues
+ *   pack   stream the loose reachable objects into a new pack and drop
+ *          the loose copies; an existing pack is only rewritten when it
+ *          holds expired objects or there are MAX_PACKS of them
+ *   prune  remove unreachable loose objects (and abandoned temp files)
+ *          older than the grace period
+ *
+ * Unreachable objects younger than the grace period are left alone. save
+ * bumps the mtime of every object (or pack) it reuses instead of writing,
+ * and writes the object again if it has disappeared. The remaining race is
+ * a gc that judged an object old just before save refreshed it, so keep
+ * the grace period non-zero while other commands may be running.
+ *
+ * @author Puneeth R (GHOST)
+ * @license MIT
+ */
+
+#include "repository.h"
+#include "utils.h"
+#include "pack.h"
+#include "transaction.h"
+#include "batchio.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_set>
+#include <zlib.h>
+
+namespace {
+
+    const char* KINDS[] = { "commits", "trees", "blobs" };
+
+    // Once there are this many packs, gc merges them into one
+    const size_t MAX_PACKS = 8;
+
+    double elapsedMs(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+    }
+
+    long long storeBytes(const std::string& objectsDir) {
+        long long total = 0;
+        std::error_code ec;
+        for (auto it = std::filesystem::recursive_directory_iterator(objectsDir, ec);
+             !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+            if (it->is_regular_file(ec))
+                total += static_cast<long long>(it->file_size(ec));
+        }
+        return total;
+    }
+
+    bool olderThan(const std::filesystem::path& path,
+                   std::filesystem::file_time_type cutoff) {
+        std::error_code ec;
+        auto mtime = std::filesystem::last_write_time(path, ec);
+        return !ec && mtime < cutoff;
+    }
+}
+
+/**
+ * Mark reachable objects, repack them and prune the rest
+ * @param grace Unreachable objects modified within this many seconds are kept
+ * @return Per-phase counts and timings; ok is false if gc was aborted
+ */
+GcStats Repository::collectGarbage(std::time_t grace) {
+    GcStats stats;
+    if (!isInitialized()) {
+        *out << "Error: not a LiteVCS repository.\n";
+        return stats;
+    }
+
+    std::string objectsDir = vcsDir + "/objects";
+    std::string packDir = objectsDir + "/pack";
+    auto cutoff = std::filesystem::file_time_type::clock::now() - std::chrono::seconds(grace);
+    long long bytesBefore = storeBytes(objectsDir);
+
+    try {
+        reloadPacks();
+
+        // Thread-safe fetch + inflate; readObject's cache is not shared
+        auto load = [this](const std::string& kind, const std::string& hash) {
+            std::string path = vcsDir + "/objects/" + kind + "/" + hash;
+            std::string compressed, content;
+            if (!readStoredObject(path, compressed) ||
+                utils::decompress(compressed, content) != Z_OK) {
+                throw std::runtime_error("reachable object " + kind + "/" + hash +
+                                         " is missing or corrupt");
+            }
+            return content;
+        };
+
+        // ---- Mark ----
+        auto start = std::chrono::steady_clock::now();
+
+        std::vector<std::string> roots{ utils::read_file(vcsDir + "/HEAD") };
+        std::error_code ec;
+        if (std::filesystem::is_directory(vcsDir + "/refs", ec)) {
+            for (const auto& ref : std::filesystem::recursive_directory_iterator(vcsDir + "/refs", ec)) {
+                if (ref.is_regular_file() &&
+                    ref.path().filename().string().find(".tmp-") == std::string::npos)
+                    roots.push_back(utils::read_file(ref.path().string()));
+            }
+        }
+
+        std::unordered_set<std::string> commits, trees, blobs;
+        std::mutex blobsMutex;
+        ThreadPool pool;
+
+        for (auto current : roots) {
+            current.erase(current.find_last_not_of(" \r\n\t") + 1);
+
+            while (!current.empty() && current != "null" && commits.insert(current).second) {
+                std::istringstream commit(load("commits", current));
+                std::string line, treeHash, parent;
+                while (std::getline(commit, line)) {
+                    if (line.rfind("tree ", 0) == 0) treeHash = line.substr(5);
+                    if (line.rfind("parent ", 0) == 0) parent = line.substr(7);
+                }
+
+                if (!treeHash.empty() && trees.insert(treeHash).second) {
+                    pool.submit([&, treeHash] {
+                        std::vector<std::string> found;
+                        std::istringstream tree(load("trees", treeHash));
+                        std::string entry;
+                        while (std::getline(tree, entry)) {
+                            auto space = entry.rfind(' ');
+                            if (space != std::string::npos) found.push_back(entry.substr(space + 1));
+                        }
+
+                        std::lock_guard<std::mutex> lock(blobsMutex);
+                        blobs.insert(found.begin(), found.end());
+                    });
+                }
+                current = parent;
+            }
+        }
+        pool.wait();
+
+        const std::unordered_set<std::string>* live[] = { &commits, &trees, &blobs };
+        stats.reachable = commits.size() + trees.size() + blobs.size();
+        stats.markMs = elapsedMs(start);
+
+        // ---- Pack ----
+        start = std::chrono::steady_clock::now();
+
+        // Packs are only rewritten to drop expired objects, or to merge once
+        // there are too many; anything else just gains a pack of loose objects
+        const pack::PackSet& existing = packs();
+        size_t packCount = existing.packFiles().size();
+        bool merge = packCount >= MAX_PACKS;
+        std::vector<char> youngPack, rewrite(packCount, merge);
+        for (const auto& file : existing.packFiles())
+            youngPack.push_back(!olderThan(file, cutoff));
+
+        for (size_t k = 0; k < 3 && !merge; ++k) {
+            for (const auto& [hash, entry] : existing.objects(KINDS[k])) {
+                if (!youngPack[entry.file] && !live[k]->count(hash))
+                    rewrite[entry.file] = true;
+            }
+        }
+
+        std::vector<std::pair<std::string, std::string>> toPack;    // kind, hash
+        std::vector<std::string> loosePacked;
+
+        for (size_t k = 0; k < 3; ++k) {
+            std::vector<std::string> sorted(live[k]->begin(), live[k]->end());
+            std::sort(sorted.begin(), sorted.end());
+            for (const auto& hash : sorted) {
+                const pack::Entry* entry = existing.find(KINDS[k], hash);
+                if (!entry || rewrite[entry->file]) toPack.emplace_back(KINDS[k], hash);
+
+                std::string loose = objectsDir + "/" + KINDS[k] + "/" + hash;
+                if (utils::exists(loose)) loosePacked.push_back(loose);
+            }
+
+            // Unreachable packed objects survive until their pack ages out
+            for (const auto& [hash, entry] : existing.objects(KINDS[k])) {
+                if (live[k]->count(hash)) continue;
+                if (!rewrite[entry.file]) {
+                    stats.kept++;
+                } else if (youngPack[entry.file]) {
+                    toPack.emplace_back(KINDS[k], hash);
+                    stats.kept++;
+                } else {
+                    stats.pruned++;
+                }
+            }
+        }
+
+        bool dropsPacks = std::find(rewrite.begin(), rewrite.end(), 1) != rewrite.end();
+        if (!toPack.empty() || dropsPacks || !loosePacked.empty()) {
+            std::string newPack;
+
+            if (!toPack.empty()) {
+                std::vector<std::string> paths;
+                for (const auto& [kind, hash] : toPack)
+                    paths.push_back(objectsDir + "/" + kind + "/" + hash);
+
+                // Each object goes straight to the pack file as its read completes
+                pack::Writer writer(packDir, txn::parseDurability(configValue("durability")));
+                batchIO().readFiles(paths,
+                    [&](size_t i, std::string&& compressed, bool ok) {
+                        if (!ok && !readStoredObject(paths[i], compressed))
+                            throw std::runtime_error("cannot read " + paths[i]);
+                        writer.add(toPack[i].first, toPack[i].second, compressed);
+                    });
+                newPack = writer.finish();
+
+                stats.packed = writer.size();
+                stats.pack = std::filesystem::path(newPack).stem().string();
+            }
+
+            // Everything below is now durable in a kept pack or the new one
+            for (const auto& loose : loosePacked)
+                std::filesystem::remove(loose, ec);
+
+            for (size_t i = 0; i < packCount; ++i) {
+                const std::string& file = existing.packFiles()[i];
+                if (!rewrite[i] || file == newPack) continue;
+                std::filesystem::remove(file.substr(0, file.size() - 5) + ".idx", ec);
+                std::filesystem::remove(file, ec);
+            }
+            reloadPacks();
+        }
+        stats.packMs = elapsedMs(start);
+
+        // ---- Prune ----
+        start = std::chrono::steady_clock::now();
+
+        for (size_t k = 0; k < 3; ++k) {
+            std::string dir = objectsDir + "/" + KINDS[k];
+            if (!std::filesystem::is_directory(dir, ec)) continue;
+
+            for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+                std::string name = entry.path().filename().string();
+                bool temp = name.find(".tmp-") != std::string::npos;
+                if (!temp && live[k]->count(name)) continue;
+
+                if (olderThan(entry.path(), cutoff)) {
+                    if (std::filesystem::remove(entry.path(), ec) && !temp) stats.pruned++;
+                } else if (!temp) {
+                    stats.kept++;
+                }
+            }
+        }
+        // Pack temp files left by an interrupted gc
+        if (std::filesystem::is_directory(packDir, ec)) {
+            for (const auto& entry : std::filesystem::directory_iterator(packDir, ec)) {
+                if (entry.path().filename().string().find(".tmp-") != std::string::npos &&
+                    olderThan(entry.path(), cutoff))
+                    std::filesystem::remove(entry.path(), ec);
+            }
+        }
+        stats.pruneMs = elapsedMs(start);
+    } catch (const std::exception& e) {
+        *out << "Error: gc failed - " << e.what() << "\n";
+        reloadPacks();
+        return stats;
+    }
+
+    stats.bytesReclaimed = bytesBefore - storeBytes(objectsDir);
+    stats.ok = true;
+    return stats;
+}
+
+/**
+ * Run gc and report what each phase did
+ * @param grace Grace period for unreachable objects, in seconds
+ */
+void Repository::gc(std::time_t grace) {
+    GcStats stats = collectGarbage(grace);
+    if (!stats.ok) return;
+
+    auto ms = [](double v) {
+        std::ostringstream s;
+        s.setf(std::ios::fixed);
+        s.precision(1);
+        s << v << " ms";
+        return s.str();
+    };
+
+    *out << "Mark:   " << stats.reachable << " reachable objects ("
+         << ms(stats.markMs) << ")\n";
+    if (stats.pack.empty()) {
+        *out << "Pack:   nothing to repack (" << ms(stats.packMs) << ")\n";
+    } else {
+        *out << "Pack:   " << stats.packed << " objects into " << stats.pack
+             << " (" << ms(stats.packMs) << ")\n";
+    }
+    *out << "Prune:  " << stats.pruned << " unreachable objects removed, "
+         << stats.kept << " kept within grace period (" << ms(stats.pruneMs) << ")\n";
+    *out << "Reclaimed " << stats.bytesReclaimed << " bytes\n";
+}
@@ -0,0 +1,203 @@
+/**
+ * LiteVCS Local IPC Implementation
+ *
+ * On platforms without Unix domain sockets every call fails, and callers
+ * fall back to doing the work in-process.
+ *
+ * @author Puneeth R (GHOST)
+ * @license MIT
+ */
+
+#include "ipc.h"
+#include <chrono>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define LITEVCS_HAVE_UNIX_SOCKETS 1
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+#endif
+
+namespace ipc {
+
+#ifdef LITEVCS_HAVE_UNIX_SOCKETS
+
+namespace {
+
+    bool makeAddress(const std::string& path, sockaddr_un& addr) {
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        // sun_path is ~108 bytes; longer paths cannot be bound
+        if (path.size() >= sizeof(addr.sun_path)) return false;
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        return true;
+    }
+}
+
+bool supported() {
+    return true;
+}
+
+int listenUnix(const std::string& path) {
+    sockaddr_un addr;
+    if (!makeAddress(path, addr)) return -1;
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        // A socket file left behind by a crashed process - replace it
+        if (errno != EADDRINUSE || ::unlink(path.c_str()) < 0 ||
+            ::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            ::close(fd);
+            return -1;
+        }
+    }
+
+    if (::listen(fd, 16) < 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int acceptClient(int listenFd) {
+    int fd;
+    do {
+        fd = ::accept(listenFd, nullptr, nullptr);
+    } while (fd < 0 && errno == EINTR);
+
+    if (fd >= 0) {
+        // A client that connects and goes quiet, or stops reading its
+        // reply, must not stall the service
+        timeval tv;
+        tv.tv_sec = 2;
+        tv.tv_usec = 0;
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    }
+    return fd;
+}
+
+int connectUnix(const std::string& path, int timeoutMs) {
+    sockaddr_un addr;
+    if (!makeAddress(path, addr)) return -1;
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+
+    timeval tv;
+    tv.tv_sec = timeoutMs / 1000;
+    tv.tv_usec = (timeoutMs % 1000) * 1000;
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool setNonBlocking(int fd) {
+    int flags = ::fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+void closeSocket(int fd) {
+    if (fd >= 0) ::close(fd);
+}
+
+bool Connection::send(const std::string& data) {
+    // Same 2 s allowance as reads for a peer that stops draining its
+    // socket; a deadline for the whole reply, so a peer that reads a few
+    // bytes at a time cannot hold the service either
+    const int SEND_TIMEOUT_MS = 2000;
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(SEND_TIMEOUT_MS);
+
+    size_t sent = 0;
+    while (sent < data.size()) {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (left <= 0) return false;
+
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                pollfd p{ fd, POLLOUT, 0 };
+                if (::poll(&p, 1, static_cast<int>(left)) > 0) continue;
+            }
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool Connection::nextLine(std::string& line) {
+    size_t pos = buffer.find('\n');
+    if (pos == std::string::npos) return false;
+
+    line = buffer.substr(0, pos);
+    buffer.erase(0, pos + 1);
+    return true;
+}
+
+bool Connection::readLine(std::string& line) {
+    while (!nextLine(line)) {
+        char chunk[4096];
+        ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        buffer.append(chunk, static_cast<size_t>(n));
+    }
+    return true;
+}
+
+bool Connection::receive() {
+    char chunk[4096];
+    while (true) {
+        ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (n > 0) {
+            buffer.append(chunk, static_cast<size_t>(n));
+            continue;
+        }
+        if (n == 0) return false;
+        if (errno == EINTR) continue;
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+}
+
+#else
+
+bool supported() { return false; }
+int listenUnix(const std::string&) { return -1; }
+int acceptClient(int) { return -1; }
+int connectUnix(const std::string&, int) { return -1; }
+bool setNonBlocking(int) { return false; }
+void closeSocket(int) {}
+bool Connection::send(const std::string&) { return false; }
+bool Connection::nextLine(std::string&) { return false; }
+bool Connection::readLine(std::string&) { return false; }
+bool Connection::receive() { return false; }
+
+#endif
+
+Connection::Connection(int fd) : fd(fd) {}
+
+Connection::~Connection() {
+    closeSocket(fd);
+}
+
+}
@@ -0,0 +1,86 @@
+/**
+ * LiteVCS Local IPC Header
+ *
+ * Minimal line-oriented Unix domain socket helpers shared by the
+ * background services (watcher daemon, server mode) and their clients.
+ *
+ * @author Puneeth R (GHOST)
+ * @license MIT
+ */
+
+#pragma once
+#include <string>
+
+namespace ipc {
+
+    /**
+     * True if this platform supports Unix domain sockets
+     */
+    bool supported();
+
+    /**
+     * Bind and listen on a socket path, replacing a stale socket file
+     * @return Listening descriptor, or -1 on failure
+     */
+    int listenUnix(const std::string& path);
+
+    /**
+     * Accept one pending client on a listening descriptor
+     * @return Client descriptor, or -1 on failure
+     */
+    int acceptClient(int listenFd);
+
+    /**
+     * Connect to a socket path
+     * @param timeoutMs Send/receive timeout applied to the connection
+     * @return Connected descriptor, or -1 if nothing is listening
+     */
+    int connectUnix(const std::string& path, int timeoutMs);
+
+    /**
+     * Switch a descriptor to non-blocking mode (for poll-driven services)
+     */
+    bool setNonBlocking(int fd);
+
+    void closeSocket(int fd);
+
+    /**
+     * Owning, buffered wrapper around a connected socket
+     */
+    class Connection {
+    public:
+        explicit Connection(int fd);
+        ~Connection();
+
+        Connection(const Connection&) = delete;
+        Connection& operator=(const Connection&) = delete;
+
+        bool valid() const { return fd >= 0; }
+        int descriptor() const { return fd; }
+        bool send(const std::string& data);
+
+        /**
+         * Read one '\n'-terminated line (terminator stripped)
+         * @return false on EOF, timeout or error
+         */
+        bool readLine(std::string& line);
+
+        /**
+         * Append whatever has arrived to the buffer without waiting for a
+         * full line (non-blocking sockets)
+         * @return false on EOF or error
+         */
+        bool receive();
+
+        /**
+         * Pop one complete buffered line, if any
+         */
+        bool nextLine(std::string& line);
+
+        size_t buffered() const { return buffer.size(); }
+
+    private:
+        int fd;
+        std::string buffer;
+    };
+}
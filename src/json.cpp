@@ -0,0 +1,206 @@
+/**
+ * LiteVCS JSON Helpers Implementation
+ *
+ * @author Puneeth R (GHOST)
+ * @license MIT
+ */
+
+#include "json.h"
+#include <cctype>
+#include <cstdio>
+
+namespace json {
+
+namespace {
+
+    class Parser {
+    public:
+        explicit Parser(const std::string& text) : text(text) {}
+
+        bool object(std::unordered_map<std::string, std::string>& fields) {
+            skipSpace();
+            if (!consume('{')) return fail("expected '{'");
+
+            skipSpace();
+            if (consume('}')) return end();
+
+            while (true) {
+                std::string key, value;
+                skipSpace();
+                if (!string(key)) return false;
+
+                skipSpace();
+                if (!consume(':')) return fail("expected ':'");
+
+                skipSpace();
+                if (!scalar(value)) return false;
+                fields[key] = value;
+
+                skipSpace();
+                if (consume('}')) return end();
+                if (!consume(',')) return fail("expected ',' or '}'");
+            }
+        }
+
+        std::string error;
+
+    private:
+        const std::string& text;
+        size_t pos = 0;
+
+        bool fail(const std::string& message) {
+            error = message + " at offset " + std::to_string(pos);
+            return false;
+        }
+
+        bool end() {
+            skipSpace();
+            return pos == text.size() ? true : fail("trailing characters");
+        }
+
+        void skipSpace() {
+            while (pos < text.size() && isspace(static_cast<unsigned char>(text[pos])))
+                pos++;
+        }
+
+        bool consume(char c) {
+            if (pos < text.size() && text[pos] == c) {
+                pos++;
+                return true;
+            }
+            return false;
+        }
+
+        static void appendUtf8(std::string& out, unsigned long cp) {
+            if (cp < 0x80) {
+                out.push_back(static_cast<char>(cp));
+            } else if (cp < 0x800) {
+                out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+                out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+            } else if (cp < 0x10000) {
+                out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+                out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+            } else {
+                out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+                out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+            }
+        }
+
+        bool hex4(unsigned long& value) {
+            if (pos + 4 > text.size()) return fail("truncated \\u escape");
+            value = 0;
+            for (int i = 0; i < 4; ++i) {
+                char c = text[pos++];
+                value <<= 4;
+                if (c >= '0' && c <= '9') value |= c - '0';
+                else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+                else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+                else return fail("bad \\u escape");
+            }
+            return true;
+        }
+
+        bool string(std::string& out) {
+            if (!consume('"')) return fail("expected string");
+
+            while (pos < text.size()) {
+                char c = text[pos++];
+                if (c == '"') return true;
+                if (c != '\\') {
+                    out.push_back(c);
+                    continue;
+                }
+
+                if (pos >= text.size()) break;
+                char e = text[pos++];
+                switch (e) {
+                case '"': out.push_back('"'); break;
+                case '\\': out.push_back('\\'); break;
+                case '/': out.push_back('/'); break;
+                case 'b': out.push_back('\b'); break;
+                case 'f': out.push_back('\f'); break;
+                case 'n': out.push_back('\n'); break;
+                case 'r': out.push_back('\r'); break;
+                case 't': out.push_back('\t'); break;
+                case 'u': {
+                    unsigned long cp = 0;
+                    if (!hex4(cp)) return false;
+                    // Surrogate pair; a lone half has no UTF-8 encoding
+                    if (cp >= 0xDC00 && cp <= 0xDFFF) return fail("unpaired surrogate");
+                    if (cp >= 0xD800 && cp <= 0xDBFF) {
+                        if (pos + 1 >= text.size() || text[pos] != '\\' || text[pos + 1] != 'u')
+                            return fail("unpaired surrogate");
+                        pos += 2;
+                        unsigned long low = 0;
+                        if (!hex4(low)) return false;
+                        if (low < 0xDC00 || low > 0xDFFF) return fail("unpaired surrogate");
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    appendUtf8(out, cp);
+                    break;
+                }
+                default:
+                    return fail("bad escape");
+                }
+            }
+            return fail("unterminated string");
+        }
+
+        bool scalar(std::string& out) {
+            if (pos >= text.size()) return fail("expected value");
+
+            char c = text[pos];
+            if (c == '"') return string(out);
+            if (c == '{' || c == '[') return fail("nested values are not supported");
+
+            size_t start = pos;
+            while (pos < text.size() &&
+                   (isalnum(static_cast<unsigned char>(text[pos])) ||
+                    text[pos] == '-' || text[pos] == '+' || text[pos] == '.'))
+                pos++;
+
+            out = text.substr(start, pos - start);
+            if (out.empty()) return fail("expected value");
+            return true;
+        }
+    };
+}
+
+std::string quote(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\b': out += "\\b"; break;
+        case '\f': out += "\\f"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                out += buf;
+            } else {
+                out.push_back(c);
+            }
+        }
+    }
+    out.push_back('"');
+    return out;
+}
+
+bool parseObject(const std::string& text,
+                 std::unordered_map<std::string, std::string>& fields,
+                 std::string& error) {
+    Parser parser(text);
+    if (parser.object(fields)) return true;
+    error = parser.error;
+    return false;
+}
+
+}
@@ -0,0 +1,32 @@
+/**
+ * LiteVCS JSON Helpers
+ *
+ * Just enough JSON for the server protocol: flat request objects in,
+ * hand-assembled responses out.
+ *
+ * @author Puneeth R (GHOST)
+ * @license MIT
+ */
+
+#pragma once
+#include <string>
+#include <unordered_map>
+
+namespace json {
+
+    /**
+     * Encode a string as a quoted JSON string literal
+     */
+    std::string quote(const std::string& s);
+
+    /**
+     * Parse a flat JSON object whose values are scalars
+     * @param fields Receives key -> value; strings are unescaped, other
+     *               values (numbers, true/false/null) keep their literal text
+     * @param error Set to a description when parsing fails
+     * @return true on success
+     */
+    bool parseObject(const std::string& text,
+                     std::unordered_map<std::string, std::string>& fields,
+                     std::string& error);
+}
@@ -0,0 +1,141 @@
+/**
+ * LiteVCS Pack Files Implementation
+ *
+ * @author Puneeth R (GHOST)
+ * @license MIT
+ */
+
+#include "pack.h"
+#include "transaction.h"
+#include "utils.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+
+namespace pack {
+
+namespace {
+
+    const char* INDEX_HEADER = "litevcs-pack 1";
+}
+
+void PackSet::load(const std::string& packDir) {
+    files.clear();
+    byKind.clear();
+
+    std::error_code ec;
+    if (!std::filesystem::is_directory(packDir, ec)) return;
+
+    std::vector<std::string> indexes;
+    for (const auto& entry : std::filesystem::directory_iterator(packDir, ec)) {
+        if (entry.path().extension() == ".idx")
+            indexes.push_back(entry.path().string());
+    }
+    std::sort(indexes.begin(), indexes.end());
+
+    for (const auto& idx : indexes) {
+        std::string packPath = idx.substr(0, idx.size() - 4) + ".pack";
+        if (!utils::exists(packPath)) continue;
+
+        std::ifstream in(idx);
+        std::string line;
+        if (!std::getline(in, line) || line != INDEX_HEADER) continue;
+
+        size_t fileIndex = files.size();
+        files.push_back(packPath);
+
+        std::string kind, hash;
+        uint64_t offset, length;
+        while (in >> kind >> hash >> offset >> length) {
+            // First pack wins if an object appears twice
+            byKind[kind].emplace(hash, Entry{ fileIndex, offset, length });
+        }
+    }
+}
+
+const Entry* PackSet::find(const std::string& kind, const std::string& hash) const {
+    auto k = byKind.find(kind);
+    if (k == byKind.end()) return nullptr;
+
+    auto it = k->second.find(hash);
+    return it == k->second.end() ? nullptr : &it->second;
+}
+
+std::vector<std::string> PackSet::withPrefix(const std::string& kind,
+                                             const std::string& prefix) const {
+    std::vector<std::string> matches;
+    auto k = byKind.find(kind);
+    if (k == byKind.end()) return matches;
+
+    for (auto it = k->second.lower_bound(prefix);
+         it != k->second.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it) {
+        matches.push_back(it->first);
+    }
+    return matches;
+}
+
+bool PackSet::read(const Entry& entry, std::string& compressed) const {
+    std::ifstream in(files[entry.file], std::ios::binary);
+    if (!in.seekg(static_cast<std::streamoff>(entry.offset))) return false;
+
+    compressed.resize(entry.length);
+    in.read(&compressed[0], static_cast<std::streamsize>(entry.length));
+    return static_cast<uint64_t>(in.gcount()) == entry.length;
+}
+
+const std::map<std::string, Entry>& PackSet::objects(const std::string& kind) const {
+    static const std::map<std::string, Entry> none;
+    auto k = byKind.find(kind);
+    return k == byKind.end() ? none : k->second;
+}
+
+Writer::Writer(const std::string& packDir, txn::Durability durability)
+    : packDir(packDir), durability(durability) {
+    utils::create_dir(packDir);
+    temp = txn::tempPath(packDir + "/pack");
+    file.open(temp, std::ios::binary | std::ios::trunc);
+    if (!file) throw std::runtime_error("cannot create " + temp);
+    index << INDEX_HEADER << "\n";
+}
+
+Writer::~Writer() {
+    if (finished) return;
+    file.close();
+    std::error_code ec;
+    std::filesystem::remove(temp, ec);
+}
+
+void Writer::add(const std::string& kind, const std::string& hash,
+                 const std::string& compressed) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (finished) throw std::logic_error("pack already finished");
+
+    file.write(compressed.data(), static_cast<std::streamsize>(compressed.size()));
+    if (!file) throw std::runtime_error("write failed for " + temp);
+
+    index << kind << " " << hash << " " << offset << " " << compressed.size() << "\n";
+    offset += compressed.size();
+    count++;
+}
+
+std::string Writer::finish() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (finished) throw std::logic_error("pack already finished");
+
+    file.close();
+    if (!file) throw std::runtime_error("write failed for " + temp);
+
+    // Name the pack after its index; the index goes last so a reader never
+    // sees it without the pack
+    std::string indexData = index.str();
+    std::string base = packDir + "/pack-" + utils::sha1(indexData);
+    txn::commitFile(temp, base + ".pack", durability);
+    finished = true;
+    txn::replaceFile(base + ".idx", indexData, durability);
+    return base + ".pack";
+}
+
+}
@@ -0,0 +1,108 @@
+/**
+ * LiteVCS Pack Files
+ *
+ * A pack stores many objects in one file so the object directories stay
+ * small. Objects keep their loose (zlib) encoding; a text index next to the
+ * pack records where each one lives:
+ *
+ *   .vcs/objects/pack/pack-<sha1>.pack   concatenated compressed objects
+ *   .vcs/objects/pack/pack-<sha1>.idx    "litevcs-pack 1", then one line per
+ *                                        object: "<kind> <hash> <offset> <length>"
+ *
+ * <kind> is the loose directory name: blobs, trees or commits.
+ *
+ * @author Puneeth R (GHOST)
+ * @license MIT
+ */
+
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace txn { enum class Durability; }
+
+namespace pack {
+
+    struct Entry {
+        size_t file;            // index into PackSet::packFiles()
+        uint64_t offset;
+        uint64_t length;
+    };
+
+    /**
+     * Every pack index in a directory, loaded into memory
+     * Read-only after load(), so lookups are safe from several threads.
+     */
+    class PackSet {
+    public:
+        /**
+         * Replace the contents with the packs currently in packDir
+         */
+        void load(const std::string& packDir);
+
+        const Entry* find(const std::string& kind, const std::string& hash) const;
+
+        /**
+         * Hashes of one kind starting with prefix, in sorted order
+         */
+        std::vector<std::string> withPrefix(const std::string& kind,
+                                            const std::string& prefix) const;
+
+        /**
+         * Read an object's compressed bytes
+         */
+        bool read(const Entry& entry, std::string& compressed) const;
+
+        const std::vector<std::string>& packFiles() const { return files; }
+        const std::map<std::string, Entry>& objects(const std::string& kind) const;
+
+    private:
+        std::vector<std::string> files;
+        std::unordered_map<std::string, std::map<std::string, Entry>> byKind;
+    };
+
+    /**
+     * Streams objects into a new pack as they arrive
+     *
+     * Objects are appended to a temp file in the pack directory, so only
+     * the index is held in memory. finish() makes the pack durable and
+     * renames it (then its index) into place; a writer destroyed before
+     * finish() removes its temp file. add() may be called from several
+     * threads. Errors are reported with std::runtime_error.
+     */
+    class Writer {
+    public:
+        Writer(const std::string& packDir, txn::Durability durability);
+        ~Writer();
+
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        void add(const std::string& kind, const std::string& hash,
+                 const std::string& compressed);
+
+        /**
+         * @return Path of the new .pack file
+         */
+        std::string finish();
+
+        size_t size() const { return count; }
+
+    private:
+        std::string packDir;
+        std::string temp;
+        txn::Durability durability;
+        std::ofstream file;
+        std::ostringstream index;
+        std::mutex mutex;
+        uint64_t offset = 0;
+        size_t count = 0;
+        bool finished = false;
+    };
+}
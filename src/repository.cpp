@@ -12,21 +12,43 @@
 
 #include "repository.h"
 #include "utils.h"
+#include "similarity.h"
+#include "watcher.h"
+#include "transaction.h"
+#include "batchio.h"
+#include "pack.h"
+#include "sparse.h"
 #include <iostream>
 #include <filesystem>
 #include <fstream>
 #include <ctime>
+#include <cstdlib>
 #include <zlib.h>
 #include <vector>
 #include <algorithm>
 #include <unordered_map>
+#include <unordered_set>
+#include <optional>
 #include <regex>
 #include <stdexcept>
+#include <system_error>
+#include <thread>
 
-Repository::Repository(const std::string& rootPath)
+Repository::Repository(const std::string& rootPath, std::ostream& output)
     : root(rootPath),
       vcsDir(rootPath + "/.vcs"),
-      indexFile(vcsDir + "/index") {}
+      indexFile(vcsDir + "/index"),
+      out(&output) {}
+
+Repository::~Repository() = default;
+
+/**
+ * Redirect messages and reports to another stream
+ * @param output Sink used by every subsequent call
+ */
+void Repository::setOutput(std::ostream& output) {
+    out = &output;
+}
 
 bool Repository::isInitialized() const {
     return utils::exists(vcsDir);
@@ -34,7 +56,7 @@ bool Repository::isInitialized() const {
 
 void Repository::init() {
     if (isInitialized()) {
-        std::cout << "Repository already initialized.\n";
+        *out << "Repository already initialized.\n";
         return;
     }
 
@@ -44,32 +66,34 @@ void Repository::init() {
 
     std::ofstream(indexFile).close();
     std::ofstream(vcsDir + "/HEAD") << "null";
-    std::ofstream(vcsDir + "/config") << "version=1";
+    std::ofstream(vcsDir + "/config") << "version=1\ndurability=batch\n";
 
-    std::cout << "Initialized empty LiteVCS repository.\n";
+    *out << "Initialized empty LiteVCS repository.\n";
 }
 
 /**
  * Track a file for version control
  * @param filePath Path to the file to track
+ * @return true if the file was added to the index
  */
-void Repository::trackFile(const std::string& filePath) {
+bool Repository::trackFile(const std::string& filePath) {
     if (!isInitialized()) {
-        std::cout << "Error: not a LiteVCS repository.\n";
-        return;
+        *out << "Error: not a LiteVCS repository.\n";
+        return false;
     }
 
     try {
-        std::filesystem::path fullPath = root + "/" + filePath;
-
-        if (!utils::exists(fullPath.string())) {
-            std::cout << "Error: file does not exist\n";
-            return;
-        }
-
+        // Relative paths are taken from the repository root, not the
+        // process's working directory, so library callers get the same result
         std::filesystem::path inputPath(filePath);
-        std::filesystem::path absolute = std::filesystem::absolute(inputPath);
         std::filesystem::path rootPath = std::filesystem::absolute(root);
+        std::filesystem::path absolute =
+            inputPath.is_absolute() ? inputPath : rootPath / inputPath;
+
+        if (!utils::exists(absolute.string())) {
+            *out << "Error: file does not exist\n";
+            return false;
+        }
 
         // Security: Prevent path traversal attacks (e.g., "../../../etc/passwd")
         std::filesystem::path canonical = std::filesystem::weakly_canonical(absolute);
@@ -79,8 +103,8 @@ void Repository::trackFile(const std::string& filePath) {
         auto [rootEnd, fileEnd] = std::mismatch(canonicalRoot.begin(), canonicalRoot.end(),
                                                  canonical.begin(), canonical.end());
         if (rootEnd != canonicalRoot.end()) {
-            std::cout << "Error: path traversal detected - file must be within repository\n";
-            return;
+            *out << "Error: path traversal detected - file must be within repository\n";
+            return false;
         }
 
         std::filesystem::path relative = std::filesystem::relative(absolute, root);
@@ -91,163 +115,416 @@ void Repository::trackFile(const std::string& filePath) {
 auto tracked = utils::read_lines(indexFile);
 for (const auto& f : tracked) {
     if (f == normalized) {
-        std::cout << "Already tracked: " << normalized << "\n";
-        return;
+        *out << "Already tracked: " << normalized << "\n";
+        return false;
     }
 }
 
         utils::append_line(indexFile, normalized);
-        std::cout << "Tracked: " << normalized << "\n";
+        *out << "Tracked: " << normalized << "\n";
+        return true;
     } catch (const std::filesystem::filesystem_error& e) {
-        std::cout << "Error: filesystem operation failed - " << e.what() << "\n";
+        *out << "Error: filesystem operation failed - " << e.what() << "\n";
     } catch (const std::exception& e) {
-        std::cout << "Error: " << e.what() << "\n";
+        *out << "Error: " << e.what() << "\n";
     }
+    return false;
 }
 
-void Repository::save(const std::string& message) {
+/**
+ * Snapshot every tracked file into a new commit
+ * @param message Commit message
+ * @return Hash of the new commit, or empty on error
+ */
+std::string Repository::save(const std::string& message) {
     if (!isInitialized()) {
-        std::cout << "Error: not a LiteVCS repository.\n";
-        return;
+        *out << "Error: not a LiteVCS repository.\n";
+        return "";
     }
     std::ifstream idx(indexFile);
     if (!idx.peek()) {
-    std::cout << "Error: no tracked files to commit.\n";
-    return;
+    *out << "Error: no tracked files to commit.\n";
+    return "";
     }
 
-    std::ifstream index(indexFile);
-    std::string file;
-    std::ostringstream tree;
+    std::string parent = utils::read_file(vcsDir + "/HEAD");
 
-    while (std::getline(index, file)) {
-        std::string blobHash = createBlob(file);
-        tree << file << " " << blobHash << "\n";
+    // Files the watcher has not seen change, and files outside the sparse
+    // checkout (never written to disk), keep their blob from HEAD
+    auto journal = watcher::query(vcsDir, parent);
+    sparse::Matcher filter = sparseMatcher();
+    std::unordered_map<std::string, std::string> headBlobs;
+    if ((journal.valid || !filter.empty()) && parent != "null" && !parent.empty()) {
+        for (const auto& [path, blob] : readTree(readCommitTree(parent)))
+            headBlobs[path] = blob;
     }
 
-    std::string treeContent = tree.str();
-    std::string treeHash = utils::sha1(treeContent);
+    txn::Durability durability = txn::parseDurability(configValue("durability"));
+    std::string commitHash;
 
-    std::string treePath = vcsDir + "/objects/trees/" + treeHash;
-    if (!std::filesystem::exists(treePath)) {
-    utils::write_binary(treePath, utils::compress(treeContent));
-    }
+    try {
+        // Objects only become visible once the whole batch is durable
+        txn::WriteTransaction objects(durability, &batchIO());
+        refreshPacks();     // createBlob runs on I/O threads; load the indexes up front
+
+        auto files = utils::read_lines(indexFile);
+        std::vector<std::string> blobHashes(files.size());
+        std::vector<size_t> toRead;
+        std::vector<std::string> readPaths;
+
+        for (size_t i = 0; i < files.size(); ++i) {
+            auto known = headBlobs.find(files[i]);
+            if (known != headBlobs.end() &&
+                (!filter.matches(files[i]) || (journal.valid && !journal.isDirty(files[i])))) {
+                blobHashes[i] = known->second;
+            } else {
+                toRead.push_back(i);
+                readPaths.push_back(root + "/" + files[i]);
+            }
+        }
 
-    std::string parent = utils::read_file(vcsDir + "/HEAD");
-    std::time_t now = std::time(nullptr);
+        // Hash and compress each file as soon as its read completes
+        std::vector<char> readOk(toRead.size(), 0);
+        batchIO().readFiles(readPaths,
+            [&](size_t k, std::string&& content, bool ok) {
+                readOk[k] = ok;
+                if (ok) blobHashes[toRead[k]] = createBlob(content, objects);
+            });
+
+        // A tracked file that is gone is recorded as deleted; one that
+        // exists but cannot be read (permissions, I/O error) aborts the save
+        for (size_t k = 0; k < toRead.size(); ++k) {
+            if (readOk[k]) continue;
+            std::error_code ec;
+            if (std::filesystem::exists(readPaths[k], ec) || ec)
+                throw std::runtime_error("cannot read " + files[toRead[k]]);
+        }
+
+        std::ostringstream tree;
+        for (size_t i = 0; i < files.size(); ++i) {
+            if (!blobHashes[i].empty())
+                tree << files[i] << " " << blobHashes[i] << "\n";
+        }
+
+        std::string treeContent = tree.str();
+        std::string treeHash = utils::sha1(treeContent);
+
+        std::string treePath = vcsDir + "/objects/trees/" + treeHash;
+        if (!reuseObject(treePath)) {
+            objects.stage(treePath, utils::compress(treeContent));
+        }
+
+        std::time_t now = std::time(nullptr);
+
+        std::ostringstream commit;
+        commit << "tree " << treeHash << "\n";
+        commit << "parent " << parent << "\n";
+        commit << "time " << now << "\n";
+        commit << "message " << message << "\n";
 
-    std::ostringstream commit;
-    commit << "tree " << treeHash << "\n";
-    commit << "parent " << parent << "\n";
-    commit << "time " << now << "\n";
-    commit << "message " << message << "\n";
+        std::string commitData = commit.str();
+        commitHash = utils::sha1(commitData);
 
-    std::string commitData = commit.str();
-    std::string commitHash = utils::sha1(commitData);
+        std::string commitPath = vcsDir + "/objects/commits/" + commitHash;
+        objects.stage(commitPath, utils::compress(commitData));
 
-    std::string commitPath = vcsDir + "/objects/commits/" + commitHash;
-    utils::write_binary(commitPath, utils::compress(commitData));
+        objects.commit();
+        recordTip(commitHash, parent, durability);
 
-    utils::write_binary(vcsDir + "/HEAD", commitHash);
+        // HEAD moves last, and atomically, so it never names a missing commit
+        txn::replaceFile(vcsDir + "/HEAD", commitHash, durability);
+    } catch (const std::exception& e) {
+        *out << "Error: save failed - " << e.what() << "\n";
+        return "";
+    }
 
-    std::cout << "Saved commit: " << commitHash.substr(0, 8) << "...\n";
+    if (journal.reachable)
+        watcher::acknowledge(vcsDir, journal.sequence, commitHash);
+
+    *out << "Saved commit: " << commitHash.substr(0, 8) << "...\n";
+    return commitHash;
+}
+
+/**
+ * Look up a key in .vcs/config ("key=value" lines)
+ * @return The value, or an empty string if unset
+ */
+std::string Repository::configValue(const std::string& key) {
+    for (const auto& line : utils::read_lines(vcsDir + "/config")) {
+        auto eq = line.find('=');
+        if (eq != std::string::npos && line.compare(0, eq, key) == 0 && eq == key.size())
+            return line.substr(eq + 1);
+    }
+    return "";
 }
 
-std::string Repository::createBlob(const std::string& filePath) {
-    std::string fullPath = root + "/" + filePath;
-    std::string content = utils::read_file(fullPath);
+/**
+ * Record a commit under .vcs/refs/tips so gc keeps it after HEAD moves away
+ * @param replaces Tip made redundant by this one (its parent), or empty
+ */
+void Repository::recordTip(const std::string& commit, const std::string& replaces,
+                           txn::Durability durability) {
+    std::string tips = vcsDir + "/refs/tips";
+    utils::create_dir(tips);
+
+    if (!utils::exists(tips + "/" + commit))
+        txn::replaceFile(tips + "/" + commit, commit, durability);
 
+    if (!replaces.empty() && replaces != commit) {
+        std::error_code ec;
+        std::filesystem::remove(tips + "/" + replaces, ec);
+    }
+}
+
+/**
+ * Hash file content and stage it as a blob if it is not stored yet
+ * Safe to call from several threads with the same transaction.
+ * @return Blob hash
+ */
+std::string Repository::createBlob(const std::string& content,
+                                   txn::WriteTransaction& objects) {
     std::string hash = utils::sha1(content);
     std::string blobPath = vcsDir + "/objects/blobs/" + hash;
 
-    if (!std::filesystem::exists(blobPath)) {
-        utils::write_binary(blobPath, utils::compress(content));
+    if (!reuseObject(blobPath)) {
+        objects.stage(blobPath, utils::compress(content));
     }
 
     return hash;
 }
 
+/**
+ * Bulk I/O backend, created on first use from the "io" config key
+ */
+batchio::BatchIO& Repository::batchIO() {
+    if (!io) io = batchio::create(configValue("io"));
+    return *io;
+}
+
+/**
+ * Pack indexes under .vcs/objects/pack, loaded on first use
+ */
+const pack::PackSet& Repository::packs() {
+    if (!packSet) {
+        packSet = std::make_unique<pack::PackSet>();
+        packSet->load(vcsDir + "/objects/pack");
+    }
+    return *packSet;
+}
+
+void Repository::reloadPacks() {
+    packSet.reset();
+    packs();
+
+    std::error_code ec;
+    packStamp = std::filesystem::last_write_time(vcsDir + "/objects/pack", ec)
+                    .time_since_epoch().count();
+}
+
+/**
+ * Reload the pack indexes if packs were added or removed since they were
+ * loaded (e.g. by a gc in another process while a server is running)
+ */
+void Repository::refreshPacks() {
+    std::error_code ec;
+    auto stamp = std::filesystem::last_write_time(vcsDir + "/objects/pack", ec)
+                     .time_since_epoch().count();
+    if (!packSet || stamp != packStamp) reloadPacks();
+}
+
+/**
+ * Claim an already stored object for a new commit instead of rewriting it
+ * Its mtime (or its pack's) is bumped so a concurrent gc treats it as new
+ * and keeps it for the grace period, as git does. Safe to call from several
+ * threads once packs() has been loaded.
+ * @return false if the object is not stored (any more) and must be written
+ */
+bool Repository::reuseObject(const std::string& path) {
+    auto now = std::filesystem::file_time_type::clock::now();
+    std::error_code ec;
+
+    std::filesystem::last_write_time(path, now, ec);
+    if (!ec) return true;
+
+    std::filesystem::path p(path);
+    const pack::Entry* entry = packs().find(p.parent_path().filename().string(),
+                                            p.filename().string());
+    if (!entry) return false;
+
+    // A stale index may name a pack another gc has already replaced
+    std::filesystem::last_write_time(packs().packFiles()[entry->file], now, ec);
+    return !ec;
+}
+
+/**
+ * Whether an object is stored, either loose or in a pack
+ * @param path Loose path of the object (.vcs/objects/<kind>/<hash>)
+ */
+bool Repository::hasObject(const std::string& path) {
+    if (std::filesystem::exists(path)) return true;
+
+    std::filesystem::path p(path);
+    return packs().find(p.parent_path().filename().string(),
+                        p.filename().string()) != nullptr;
+}
+
+/**
+ * Fetch an object's compressed bytes from its loose file or a pack
+ * Safe to call from several threads once packs() has been loaded.
+ * @param path Loose path of the object
+ */
+bool Repository::readStoredObject(const std::string& path, std::string& compressed) {
+    std::ifstream in(path, std::ios::binary);
+    if (in) {
+        compressed.assign(std::istreambuf_iterator<char>(in),
+                          std::istreambuf_iterator<char>());
+        return true;
+    }
+
+    std::filesystem::path p(path);
+    const pack::Entry* entry = packs().find(p.parent_path().filename().string(),
+                                            p.filename().string());
+    return entry && packs().read(*entry, compressed);
+}
+
 /**
  * Read and decompress a stored object
  * @param path Path to the compressed object
  * @return Decompressed content
  */
 std::string Repository::readObject(const std::string& path) {
-    std::ifstream in(path, std::ios::binary);
-    if (!in) {
-        std::cout << "Error: object missing: " << path << "\n";
-        return {};
+    // Long-lived instances (server mode) keep recently used objects warm
+    const size_t MAX_CACHE_BYTES = 64 * 1024 * 1024;
+
+    auto cached = objectCache.find(path);
+    if (cached != objectCache.end()) return cached->second;
+
+    std::string compressed;
+    if (!readStoredObject(path, compressed)) {
+        // Another process may have repacked since the indexes were loaded
+        reloadPacks();
+        if (!readStoredObject(path, compressed)) {
+            *out << "Error: object missing: " << path << "\n";
+            return {};
+        }
     }
 
-    std::vector<char> compressed((std::istreambuf_iterator<char>(in)),
-                                  std::istreambuf_iterator<char>());
-
-    // Security: Prevent decompression bombs by limiting output size
-    const uLongf MAX_DECOMPRESSED_SIZE = 100 * 1024 * 1024; // 100 MB limit
-    uLongf outCap = std::min(static_cast<uLongf>(compressed.size() * 6 + 64), MAX_DECOMPRESSED_SIZE);
-    std::vector<Bytef> out(outCap);
-
-    int res = ::uncompress(out.data(), &outCap,
-                            reinterpret_cast<Bytef*>(compressed.data()),
-                            compressed.size());
+    std::string content;
+    int res = utils::decompress(compressed, content);
 
     if (res != Z_OK) {
         if (res == Z_BUF_ERROR) {
-            std::cout << "Error: decompressed object too large (possible decompression bomb)\n";
+            *out << "Error: decompressed object too large (possible decompression bomb)\n";
         } else {
-            std::cout << "Error: failed to decompress object (code: " << res << ")\n";
+            *out << "Error: failed to decompress object (code: " << res << ")\n";
         }
         return {};
     }
 
-    return std::string(reinterpret_cast<char*>(out.data()), outCap);
+    if (objectCacheBytes + content.size() > MAX_CACHE_BYTES) {
+        objectCache.clear();
+        objectCacheBytes = 0;
+    }
+    if (content.size() <= MAX_CACHE_BYTES) {
+        objectCacheBytes += content.size();
+        objectCache.emplace(path, content);
+    }
+    return content;
 }
 
-void Repository::showHistory() {
-    if (!isInitialized()) {
-        std::cout << "Error: not a LiteVCS repository.\n";
-        return;
-    }
+/**
+ * Walk the history from HEAD back to the root commit
+ * @return Commits, newest first
+ */
+std::vector<CommitInfo> Repository::listCommits() {
+    std::vector<CommitInfo> commits;
+    if (!isInitialized()) return commits;
 
     std::string current = utils::read_file(vcsDir + "/HEAD");
 
     while (current != "null" && !current.empty()) {
         std::string path = vcsDir + "/objects/commits/" + current;
         std::string data = readObject(path);
+        if (data.empty()) break;
+
+        CommitInfo info;
+        info.hash = current;
 
         std::istringstream iss(data);
-        std::string line, parent, message, time;
+        std::string line;
 
         while (std::getline(iss, line)) {
-            if (line.rfind("parent", 0) == 0) parent = line.substr(7);
-            if (line.rfind("time", 0) == 0) time = line.substr(5);
-            if (line.rfind("message", 0) == 0) message = line.substr(8);
+            if (line.rfind("tree", 0) == 0) info.tree = line.substr(5);
+            if (line.rfind("parent", 0) == 0) info.parent = line.substr(7);
+            if (line.rfind("time", 0) == 0)
+                info.time = static_cast<std::time_t>(std::strtoll(line.c_str() + 5, nullptr, 10));
+            if (line.rfind("message", 0) == 0) info.message = line.substr(8);
         }
 
-        std::cout << "commit " << current.substr(0, 8) << "\n";
-        std::cout << "Date: " << time << "\n";
-        std::cout << "Message: " << message << "\n\n";
+        current = info.parent;
+        commits.push_back(std::move(info));
+    }
+    return commits;
+}
+
+void Repository::showHistory() {
+    if (!isInitialized()) {
+        *out << "Error: not a LiteVCS repository.\n";
+        return;
+    }
 
-        current = parent;
+    for (const auto& commit : listCommits()) {
+        *out << "commit " << commit.hash.substr(0, 8) << "\n";
+        *out << "Date: " << commit.time << "\n";
+        *out << "Message: " << commit.message << "\n\n";
     }
 }
 
-void Repository::goToCommit(const std::string& commitHash) {
+bool Repository::goToCommit(const std::string& commitHash) {
+    return checkout(commitHash, nullptr);
+}
+
+/**
+ * Check out a commit and replace the sparse-checkout patterns
+ * @param sparsePatterns Paths/globs to materialize; empty means the whole tree
+ */
+bool Repository::goToCommit(const std::string& commitHash,
+                            const std::vector<std::string>& sparsePatterns) {
+    return checkout(commitHash, &sparsePatterns);
+}
+
+/**
+ * Patterns in .vcs/sparse-checkout; empty when the whole tree is checked out
+ */
+std::vector<std::string> Repository::sparsePatterns() {
+    return sparseMatcher().source();
+}
+
+sparse::Matcher Repository::sparseMatcher() {
+    return sparse::Matcher(sparse::load(vcsDir));
+}
+
+/**
+ * Write the files of a commit that match the sparse patterns, then move HEAD
+ * @param sparsePatterns New patterns to store, or null to keep the current ones
+ */
+bool Repository::checkout(const std::string& commitHash,
+                          const std::vector<std::string>* sparsePatterns) {
    std::string resolved = resolveCommitHash(commitHash);
     if (resolved.empty()) {
-    std::cout << "Error: commit hash ambiguous or not found\n";
-    return;
+    *out << "Error: commit hash ambiguous or not found\n";
+    return false;
     }
     if (resolved.empty()) {
-    std::cout << "Error: commit hash ambiguous or not found\n";
-    return;
+    *out << "Error: commit hash ambiguous or not found\n";
+    return false;
     }
 
 std::string commitPath = vcsDir + "/objects/commits/" + resolved;
 
-    if (!std::filesystem::exists(commitPath)) {
-        std::cout << "Error: commit not found\n";
-        return;
+    if (!hasObject(commitPath)) {
+        *out << "Error: commit not found\n";
+        return false;
     }
 
     std::string commitData = readObject(commitPath);
@@ -259,21 +536,174 @@ std::string commitPath = vcsDir + "/objects/commits/" + resolved;
             treeHash = line.substr(5);
     }
 
-    std::string treePath = vcsDir + "/objects/trees/" + treeHash;
-    std::string treeData = readObject(treePath);
+    // Entries outside the sparse patterns are never inflated or written.
+    // New patterns are only stored once the checkout has gone through.
+    sparse::Matcher filter = sparsePatterns ? sparse::Matcher(*sparsePatterns)
+                                            : sparseMatcher();
+    auto entries = readTree(treeHash, &filter);
 
-    std::istringstream treeStream(treeData);
-    std::string file, blobHash;
+    // Files are inflated and written in chunks so memory stays bounded on
+    // huge trees; each chunk's writes overlap the next chunk's reads
+    const size_t CHUNK_FILES = 256;
+
+    std::vector<std::string> blobPaths;
+    std::vector<std::string> targets;
+    std::unordered_set<std::string> dirs;
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+        blobPaths.push_back(vcsDir + "/objects/blobs/" + entries[i].second);
+
+        std::filesystem::path target = std::filesystem::path(root) / entries[i].first;
+        if (target.has_parent_path() && dirs.insert(target.parent_path().string()).second)
+            std::filesystem::create_directories(target.parent_path());
+        targets.push_back(target.string());
+    }
+
+    // Writes run on their own backend instance so they can be in flight
+    // while batchIO() is reading
+    std::unique_ptr<batchio::BatchIO> writer = batchio::create(configValue("io"));
+    std::vector<batchio::WriteRequest> writing;
+    std::vector<int> results;
+    std::exception_ptr writeError;
+    std::thread writeThread;
+    size_t written = 0;
+
+    auto finishWrites = [&] {
+        if (!writeThread.joinable()) return;
+        writeThread.join();
+        if (writeError) std::rethrow_exception(writeError);
+
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (results[i] != 0) {
+                *out << "Error: cannot write " << writing[i].path << ": "
+                     << std::generic_category().message(results[i]) << "\n";
+            } else {
+                written++;
+            }
+        }
+        writing.clear();
+    };
+
+    // Events after this point include our own writes and any edit made
+    // while checkout runs; only those before it may be acknowledged
+    std::string previous = utils::read_file(vcsDir + "/HEAD");
+    auto journal = watcher::query(vcsDir, previous);
+
+    // Files that drop out of narrowed patterns are removed, since diff and
+    // save would ignore any edit to them; one with local changes blocks it
+    std::vector<std::string> leaving;
+    if (sparsePatterns && previous != "null" && !previous.empty()) {
+        sparse::Matcher current = sparseMatcher();
+        for (const auto& [path, blob] : readTree(readCommitTree(previous), &current)) {
+            std::string full = root + "/" + path;
+            if (filter.matches(path) || !utils::exists(full)) continue;
+
+            bool clean = journal.valid && !journal.isDirty(path);
+            if (!clean && utils::sha1(utils::read_file(full)) != blob) {
+                *out << "Error: " << path << " has local changes and is outside "
+                     << "the new sparse patterns; save or restore it first\n";
+                return false;
+            }
+            leaving.push_back(full);
+        }
+    }
+
+    // Packed blobs have no loose file and are read from their pack instead
+    refreshPacks();
+    try {
+        for (size_t start = 0; start < entries.size(); start += CHUNK_FILES) {
+            size_t end = std::min(entries.size(), start + CHUNK_FILES);
+            std::vector<std::string> paths(blobPaths.begin() + start, blobPaths.begin() + end);
+            std::vector<batchio::WriteRequest> chunk(paths.size());
+            std::vector<char> inflated(paths.size(), 0);
+
+            // Inflate blobs while the remaining reads are still in flight
+            batchIO().readFiles(paths,
+                [&](size_t i, std::string&& compressed, bool ok) {
+                    if (!ok) ok = readStoredObject(paths[i], compressed);
+                    inflated[i] = ok && utils::decompress(compressed, chunk[i].data) == Z_OK;
+                });
+
+            std::vector<batchio::WriteRequest> ready;
+            for (size_t i = 0; i < paths.size(); ++i) {
+                if (!inflated[i]) {
+                    *out << "Error: object missing or corrupt: " << paths[i] << "\n";
+                    continue;
+                }
+                chunk[i].path = targets[start + i];
+                ready.push_back(std::move(chunk[i]));
+            }
+
+            finishWrites();
+            writing = std::move(ready);
+            writeThread = std::thread([&] {
+                try {
+                    results = writer->writeFiles(writing);
+                } catch (...) {
+                    writeError = std::current_exception();
+                }
+            });
+        }
+        finishWrites();
+    } catch (const std::exception& e) {
+        if (writeThread.joinable()) writeThread.join();
+        *out << "Error: checkout failed - " << e.what() << "\n";
+        return false;
+    }
+
+    // A half-written tree must not look like a finished checkout
+    if (written < entries.size()) {
+        *out << "Error: checkout incomplete - " << entries.size() - written
+             << " files not written; HEAD unchanged\n";
+        return false;
+    }
+
+    txn::Durability durability = txn::parseDurability(configValue("durability"));
+
+    if (sparsePatterns) {
+        try {
+            for (const auto& path : leaving) {
+                std::filesystem::remove(path);
+
+                // Drop directories the removal left empty
+                std::error_code ec;
+                for (auto dir = std::filesystem::path(path).parent_path();
+                     dir.string().size() > root.size() &&
+                     std::filesystem::is_empty(dir, ec) && !ec;
+                     dir = dir.parent_path()) {
+                    if (!std::filesystem::remove(dir, ec)) break;
+                }
+            }
+            sparse::store(vcsDir, *sparsePatterns, durability);
+        } catch (const std::exception& e) {
+            *out << "Error: cannot update sparse checkout - " << e.what() << "\n";
+            return false;
+        }
+    }
 
-    while (treeStream >> file >> blobHash) {
-        std::string blobPath = vcsDir + "/objects/blobs/" + blobHash;
-        std::string content = readObject(blobPath);
+    try {
+        // Keep the commit we are leaving reachable for gc
+        if (previous != resolved && previous != "null" && !previous.empty())
+            recordTip(previous, "", durability);
 
-        std::ofstream(root + "/" + file, std::ios::binary) << content;
+        txn::replaceFile(vcsDir + "/HEAD", resolved, durability);
+    } catch (const std::exception& e) {
+        *out << "Error: cannot update HEAD - " << e.what() << "\n";
+        return false;
     }
 
-    utils::write_binary(vcsDir + "/HEAD", commitHash);
-    std::cout << "Moved to commit " << commitHash.substr(0, 8) << "\n";
+    // Checked-out files now match the commit; let the watcher forget them
+    if (journal.reachable)
+        watcher::acknowledge(vcsDir, journal.sequence, resolved);
+
+    *out << "Moved to commit " << resolved.substr(0, 8);
+    if (!filter.empty()) {
+        *out << " (sparse checkout: " << written << " files";
+        if (!leaving.empty()) *out << ", " << leaving.size() << " removed";
+        *out << ")";
+    }
+    *out << "\n";
+    return true;
 }
 
 std::string Repository::resolveCommitHash(const std::string& prefix) {
@@ -282,6 +712,7 @@ std::string Repository::resolveCommitHash(const std::string& prefix) {
 
     for (const auto& entry : std::filesystem::directory_iterator(commitsDir)) {
         std::string filename = entry.path().filename().string();
+        if (filename.find(".tmp-") != std::string::npos) continue;
 
         if (filename.rfind(prefix, 0) == 0) { // starts with prefix
             if (!match.empty()) {
@@ -290,6 +721,12 @@ std::string Repository::resolveCommitHash(const std::string& prefix) {
             match = filename;
         }
     }
+
+    for (const auto& hash : packs().withPrefix("commits", prefix)) {
+        if (hash == match) continue;   // packed and still loose
+        if (!match.empty()) return "";
+        match = hash;
+    }
     return match;
 }
 
@@ -303,7 +740,7 @@ std::vector<std::string> Repository::splitLines(const std::string& content) {
     return lines;
 }
 
-std::vector<std::pair<char, std::string>>
+std::vector<DiffHunk>
 Repository::lcsDiff(const std::vector<std::string>& a,
                     const std::vector<std::string>& b) {
 
@@ -323,34 +760,46 @@ Repository::lcsDiff(const std::vector<std::string>& a,
         }
     }
 
-    // Reconstruct diff
-    std::vector<std::pair<char, std::string>> result;
+    // Reconstruct diff, grouping consecutive changes into hunks
+    std::vector<DiffHunk> result;
+    bool inHunk = false;
     int i = 0, j = 0;
 
+    auto emit = [&](char type, const std::string& text) {
+        if (!inHunk) {
+            result.push_back({ i + 1, j + 1, {} });
+            inHunk = true;
+        }
+        result.back().lines.push_back({ type, text });
+    };
+
     while (i < n && j < m) {
         if (a[i] == b[j]) {
             // unchanged line → skip
+            inHunk = false;
             i++;
             j++;
         }
         else if (dp[i + 1][j] >= dp[i][j + 1]) {
-            result.push_back({ '-', a[i] });
+            emit('-', a[i]);
             i++;
         }
         else {
-            result.push_back({ '+', b[j] });
+            emit('+', b[j]);
             j++;
         }
     }
 
     // Remaining deletions
     while (i < n) {
-        result.push_back({ '-', a[i++] });
+        emit('-', a[i]);
+        i++;
     }
 
     // Remaining insertions
     while (j < m) {
-        result.push_back({ '+', b[j++] });
+        emit('+', b[j]);
+        j++;
     }
 
     return result;
@@ -371,20 +820,9 @@ bool Repository::isIgnorableLine(const std::string& line,
     return false;
 }
 
-void Repository::diff(bool ignoreEmpty, bool ignoreWhitespace) {
-    if (!isInitialized()) {
-        std::cout << "Error: not a LiteVCS repository.\n";
-        return;
-    }
-
-    std::string head = utils::read_file(vcsDir + "/HEAD");
-    if (head == "null" || head.empty()) {
-        std::cout << "No commits to compare against.\n";
-        return;
-    }
-
+std::string Repository::readCommitTree(const std::string& commitHash) {
     std::string commitData =
-        readObject(vcsDir + "/objects/commits/" + head);
+        readObject(vcsDir + "/objects/commits/" + commitHash);
 
     std::istringstream commitStream(commitData);
     std::string line, treeHash;
@@ -393,52 +831,368 @@ void Repository::diff(bool ignoreEmpty, bool ignoreWhitespace) {
         if (line.rfind("tree", 0) == 0)
             treeHash = line.substr(5);
     }
+    return treeHash;
+}
 
+/**
+ * Parse a tree object
+ * @param filter Sparse matcher; entries it rejects are skipped during the walk
+ * @return (path, blob hash) pairs in tree order
+ */
+std::vector<std::pair<std::string, std::string>>
+Repository::readTree(const std::string& treeHash, const sparse::Matcher* filter) {
     std::string treeData =
         readObject(vcsDir + "/objects/trees/" + treeHash);
 
     std::istringstream treeStream(treeData);
     std::string filePath, blobHash;
-    bool anyChange = false;
+    std::vector<std::pair<std::string, std::string>> entries;
 
     while (treeStream >> filePath >> blobHash) {
-        std::filesystem::path wp =
-        std::filesystem::path(root) / filePath;
+        if (filter && !filter->matches(filePath)) continue;
+        entries.emplace_back(filePath, blobHash);
+    }
+    return entries;
+}
 
-    if (!std::filesystem::exists(wp)) {
-        std::cout << "diff -- " << filePath << "\n";
-        std::cout << "- [file deleted]\n\n";
-        anyChange = true;
-        continue;  
+/**
+ * Drop ignorable lines, and hunks left empty by that
+ */
+void Repository::filterHunks(std::vector<DiffHunk>& hunks,
+                             bool ignoreEmpty, bool ignoreWhitespace) {
+    for (auto& hunk : hunks) {
+        auto& lines = hunk.lines;
+        lines.erase(std::remove_if(lines.begin(), lines.end(),
+                        [&](const auto& l) {
+                            return isIgnorableLine(l.second, ignoreEmpty, ignoreWhitespace);
+                        }),
+                    lines.end());
     }
+    hunks.erase(std::remove_if(hunks.begin(), hunks.end(),
+                    [](const DiffHunk& h) { return h.lines.empty(); }),
+                hunks.end());
+}
 
-        auto oldLines = splitLines(
-            readObject(vcsDir + "/objects/blobs/" + blobHash));
-        auto newLines = splitLines(
-            utils::read_file(root + "/" + filePath));
+/**
+ * Compare the working tree against HEAD
+ * @return One entry per changed file, in report order
+ */
+std::vector<FileDiff> Repository::computeDiff(bool ignoreEmpty, bool ignoreWhitespace,
+                                              const RenameOptions& renames) {
+    std::vector<FileDiff> result;
+    if (!isInitialized()) return result;
+
+    std::string head = utils::read_file(vcsDir + "/HEAD");
+    if (head == "null" || head.empty()) return result;
+
+    sparse::Matcher filter = sparseMatcher();
+    auto entries = readTree(readCommitTree(head), &filter);
+    std::vector<std::pair<std::string, std::string>> deleted;
+
+    auto journal = watcher::query(vcsDir, head);
 
-        auto changes = lcsDiff(oldLines, newLines);
+    // Working files are read in chunks so memory stays bounded on huge
+    // trees; results keep tree order
+    const size_t CHUNK_FILES = 256;
 
-        bool printedHeader = false;
-        for (auto& [type, text] : changes) {
+    for (size_t start = 0; start < entries.size(); start += CHUNK_FILES) {
+        size_t end = std::min(entries.size(), start + CHUNK_FILES);
 
-            if (isIgnorableLine(text, ignoreEmpty, ignoreWhitespace))
+        // 'D' deleted, 'R' read from disk, 0 skipped
+        std::vector<char> action(end - start, 0);
+        std::vector<size_t> slot(end - start, 0);
+        std::vector<std::string> workingPaths;
+
+        for (size_t i = start; i < end; ++i) {
+            const auto& [filePath, blobHash] = entries[i];
+            if (journal.valid && !journal.isDirty(filePath))
                 continue;
 
-            if (!printedHeader) {
-                std::cout << "diff -- " << filePath << "\n";
-                printedHeader = true;
-                anyChange = true;
+            std::filesystem::path wp =
+                std::filesystem::path(root) / filePath;
+
+            if (!std::filesystem::exists(wp)) {
+                // Deletions may turn out to be renames; report them afterwards
+                if (renames.detectRenames)
+                    deleted.emplace_back(filePath, blobHash);
+                else
+                    action[i - start] = 'D';
+                continue;
+            }
+
+            action[i - start] = 'R';
+            slot[i - start] = workingPaths.size();
+            workingPaths.push_back(wp.string());
+        }
+
+        std::vector<std::string> working(workingPaths.size());
+        std::vector<char> readOk(workingPaths.size(), 0);
+        batchIO().readFiles(workingPaths,
+            [&](size_t k, std::string&& data, bool ok) {
+                readOk[k] = ok;
+                working[k] = std::move(data);
+            });
+
+        for (size_t i = start; i < end; ++i) {
+            const auto& [filePath, blobHash] = entries[i];
+
+            if (action[i - start] == 'D') {
+                FileDiff file;
+                file.kind = FileDiff::Kind::Deleted;
+                file.path = filePath;
+                result.push_back(std::move(file));
+                continue;
+            }
+            if (action[i - start] != 'R') continue;
+
+            // An unreadable file is not an empty one; don't report it as cleared
+            size_t k = slot[i - start];
+            if (!readOk[k]) {
+                *out << "Error: cannot read " << filePath << "\n";
+                continue;
+            }
+
+            auto oldLines = splitLines(
+                readObject(vcsDir + "/objects/blobs/" + blobHash));
+            auto newLines = splitLines(working[k]);
+            std::string().swap(working[k]);
+
+            FileDiff file;
+            file.path = filePath;
+            file.hunks = lcsDiff(oldLines, newLines);
+            filterHunks(file.hunks, ignoreEmpty, ignoreWhitespace);
+
+            if (!file.hunks.empty())
+                result.push_back(std::move(file));
+        }
+    }
+
+    if (renames.detectRenames)
+        detectRenames(entries, deleted, renames, filter, ignoreEmpty, ignoreWhitespace, result);
+
+    return result;
+}
+
+void Repository::printFileDiff(const FileDiff& file) {
+    switch (file.kind) {
+    case FileDiff::Kind::Deleted:
+        *out << "diff -- " << file.path << "\n";
+        *out << "- [file deleted]\n\n";
+        return;
+    case FileDiff::Kind::Added:
+        *out << "diff -- " << file.path << "\n";
+        *out << "+ [new file]\n\n";
+        return;
+    case FileDiff::Kind::Renamed:
+    case FileDiff::Kind::Copied:
+        *out << (file.kind == FileDiff::Kind::Renamed ? "rename" : "copy")
+             << " -- " << file.oldPath << " -> " << file.path
+             << " (" << file.similarity << "%)\n";
+        break;
+    case FileDiff::Kind::Modified:
+        *out << "diff -- " << file.path << "\n";
+        break;
+    }
+
+    for (const auto& hunk : file.hunks) {
+        for (const auto& [type, text] : hunk.lines)
+            *out << type << " " << text << "\n";
+    }
+    *out << "\n";
+}
+
+void Repository::diff(bool ignoreEmpty, bool ignoreWhitespace,
+                      const RenameOptions& renames) {
+    if (!isInitialized()) {
+        *out << "Error: not a LiteVCS repository.\n";
+        return;
+    }
+
+    std::string head = utils::read_file(vcsDir + "/HEAD");
+    if (head == "null" || head.empty()) {
+        *out << "No commits to compare against.\n";
+        return;
+    }
+
+    auto files = computeDiff(ignoreEmpty, ignoreWhitespace, renames);
+    for (const auto& file : files)
+        printFileDiff(file);
+
+    if (files.empty()) {
+        *out << "No changes detected.\n";
+    }
+}
+
+/**
+ * Pair newly tracked files with deleted (and, for -C, existing) files.
+ *
+ * Exact blob-hash matches are accepted without diffing. Everything else is
+ * shortlisted by comparing MinHash sketches of the line sets, and the LCS
+ * diff only runs against the few best-scoring candidates.
+ */
+void Repository::detectRenames(
+        const std::vector<std::pair<std::string, std::string>>& entries,
+        const std::vector<std::pair<std::string, std::string>>& deleted,
+        const RenameOptions& renames,
+        const sparse::Matcher& filter,
+        bool ignoreEmpty, bool ignoreWhitespace,
+        std::vector<FileDiff>& result) {
+
+    // Full diffs run against at most this many sketch-ranked candidates
+    const size_t MAX_CANDIDATES = 3;
+
+    struct Source {
+        std::string path;
+        std::string blob;
+        bool deleted;
+        bool claimed;
+        std::optional<similarity::Sketch> sketch;
+    };
+
+    std::vector<Source> sources;
+    for (const auto& [path, blob] : deleted)
+        sources.push_back({ path, blob, true, false, std::nullopt });
+
+    // Like git's -C, copies come from files changed in this diff; only
+    // copiesHarder makes every unchanged file a source, which sketches
+    // every blob in the tree
+    if (renames.detectCopies) {
+        std::unordered_set<std::string> modified;
+        for (const auto& f : result) {
+            if (f.kind == FileDiff::Kind::Modified) modified.insert(f.path);
+        }
+
+        std::unordered_set<std::string> gone;
+        for (const auto& d : deleted) gone.insert(d.first);
+        for (const auto& [path, blob] : entries) {
+            if (!gone.count(path) && (renames.copiesHarder || modified.count(path)))
+                sources.push_back({ path, blob, false, false, std::nullopt });
+        }
+    }
+
+    std::unordered_map<std::string, std::vector<size_t>> byBlob;
+    for (size_t i = 0; i < sources.size(); ++i)
+        byBlob[sources[i].blob].push_back(i);
+
+    // Newly tracked files: in the index but not in the HEAD tree
+    std::unordered_set<std::string> inTree;
+    for (const auto& e : entries) inTree.insert(e.first);
+
+    std::vector<std::string> added;
+    for (const auto& f : utils::read_lines(indexFile)) {
+        if (!inTree.count(f) && filter.matches(f) && utils::exists(root + "/" + f))
+            added.push_back(f);
+    }
+
+    // A deleted file can be renamed once; afterwards it can only be copied
+    auto usable = [&](const Source& s) {
+        return !s.deleted || !s.claimed || renames.detectCopies;
+    };
+
+    std::unordered_map<std::string, std::vector<std::string>> blobLines;
+    auto linesOf = [&](const std::string& blob) -> const std::vector<std::string>& {
+        auto it = blobLines.find(blob);
+        if (it == blobLines.end()) {
+            it = blobLines.emplace(blob,
+                splitLines(readObject(vcsDir + "/objects/blobs/" + blob))).first;
+        }
+        return it->second;
+    };
+
+    const double minEstimate = similarity::minimumEstimate(renames.threshold);
+
+    for (const auto& newPath : added) {
+        std::string content = utils::read_file(root + "/" + newPath);
+        std::string hash = utils::sha1(content);
+
+        int best = -1;
+        int bestScore = -1;
+        std::vector<DiffHunk> bestHunks;
+
+        // Exact content match - free, prefer an unclaimed deletion
+        auto exact = byBlob.find(hash);
+        if (exact != byBlob.end()) {
+            for (size_t i : exact->second) {
+                if (!usable(sources[i])) continue;
+                bool rename = sources[i].deleted && !sources[i].claimed;
+                if (best < 0 || rename) {
+                    best = static_cast<int>(i);
+                    bestScore = 100;
+                    if (rename) break;
+                }
+            }
+        }
+
+        if (best < 0) {
+            auto newLines = splitLines(content);
+            auto newSketch = similarity::build(newLines);
+
+            std::vector<std::pair<double, size_t>> shortlist;
+            for (size_t i = 0; i < sources.size(); ++i) {
+                Source& s = sources[i];
+                if (!usable(s)) continue;
+                if (!s.sketch) s.sketch = similarity::build(linesOf(s.blob));
+
+                double e = similarity::estimate(*s.sketch, newSketch);
+                if (e >= minEstimate) shortlist.emplace_back(e, i);
             }
 
-            std::cout << type << " " << text << "\n";
+            size_t keep = std::min(MAX_CANDIDATES, shortlist.size());
+            std::partial_sort(shortlist.begin(), shortlist.begin() + keep,
+                              shortlist.end(),
+                              [](const auto& x, const auto& y) { return x.first > y.first; });
+            shortlist.resize(keep);
+
+            for (const auto& candidate : shortlist) {
+                size_t i = candidate.second;
+                const auto& oldLines = linesOf(sources[i].blob);
+                auto hunks = lcsDiff(oldLines, newLines);
+
+                size_t removed = 0;
+                for (const auto& h : hunks)
+                    for (const auto& l : h.lines)
+                        if (l.first == '-') removed++;
+
+                size_t common = oldLines.size() - removed;
+                size_t longest = std::max(oldLines.size(), newLines.size());
+                int score = longest == 0 ? 100
+                    : static_cast<int>(common * 100 / longest);
+
+                if (score >= renames.threshold && score > bestScore) {
+                    best = static_cast<int>(i);
+                    bestScore = score;
+                    bestHunks = std::move(hunks);
+                }
+            }
+        }
+
+        FileDiff file;
+        file.path = newPath;
+
+        if (best < 0) {
+            file.kind = FileDiff::Kind::Added;
+            result.push_back(std::move(file));
+            continue;
         }
 
-        if (printedHeader) std::cout << "\n";
+        Source& src = sources[best];
+        bool rename = src.deleted && !src.claimed;
+        if (rename) src.claimed = true;
+
+        file.kind = rename ? FileDiff::Kind::Renamed : FileDiff::Kind::Copied;
+        file.oldPath = src.path;
+        file.similarity = bestScore;
+        file.hunks = std::move(bestHunks);
+        filterHunks(file.hunks, ignoreEmpty, ignoreWhitespace);
+        result.push_back(std::move(file));
     }
 
-    if (!anyChange) {
-        std::cout << "No changes detected.\n";
+    for (const auto& s : sources) {
+        if (!s.deleted || s.claimed) continue;
+        FileDiff file;
+        file.kind = FileDiff::Kind::Deleted;
+        file.path = s.path;
+        result.push_back(std::move(file));
     }
 }
 
@@ -472,13 +1226,13 @@ std::string Repository::extractFunction(const std::string& line) {
 
 void Repository::diffSmart(bool ignoreEmpty, bool ignoreWhitespace) {
     if (!isInitialized()) {
-        std::cout << "Error: not a LiteVCS repository.\n";
+        *out << "Error: not a LiteVCS repository.\n";
         return;
     }
 
     std::string head = utils::read_file(vcsDir + "/HEAD");
     if (head == "null" || head.empty()) {
-        std::cout << "No commits to compare against.\n";
+        *out << "No commits to compare against.\n";
         return;
     }
 
@@ -500,13 +1254,21 @@ void Repository::diffSmart(bool ignoreEmpty, bool ignoreWhitespace) {
     std::string filePath, blobHash;
     bool anyMeaningful = false;
 
+    auto journal = watcher::query(vcsDir, head);
+    sparse::Matcher filter = sparseMatcher();
+
     while (treeStream >> filePath >> blobHash) {
+        if (!filter.matches(filePath))
+            continue;
+        if (journal.valid && !journal.isDirty(filePath))
+            continue;
+
          std::filesystem::path wp =
         std::filesystem::path(root) / filePath;
 
     if (!std::filesystem::exists(wp)) {
-        std::cout << "diff -- " << filePath << "\n";
-        std::cout << "- [file deleted]\n\n";
+        *out << "diff -- " << filePath << "\n";
+        *out << "- [file deleted]\n\n";
         anyMeaningful = true;
         continue;  
     }
@@ -540,17 +1302,111 @@ void Repository::diffSmart(bool ignoreEmpty, bool ignoreWhitespace) {
             if (it == newFns.end()) continue;
             if (oldBody != it->second) {
                 if (!anyMeaningful) {
-                    std::cout << "smart-diff -- " << filePath << "\n\n";
+                    *out << "smart-diff -- " << filePath << "\n\n";
                 }
                 anyMeaningful = true;
-                std::cout << "Modified function: " << fn << "()\n";
+                *out << "Modified function: " << fn << "()\n";
             }
         }
     }
 
     if (!anyMeaningful) {
-        std::cout << "No meaningful changes detected.\n";
+        *out << "No meaningful changes detected.\n";
+    }
+}
+
+/**
+ * Compare tracked files against HEAD
+ * @param journal Watcher answer; when valid, only dirty paths are examined
+ * @return ('M' modified | 'D' deleted | 'A' new, path) pairs
+ */
+std::vector<StatusEntry>
+Repository::scanChanges(const watcher::Journal& journal) {
+    std::vector<StatusEntry> changes;
+
+    std::string head = utils::read_file(vcsDir + "/HEAD");
+    sparse::Matcher filter = sparseMatcher();
+    std::vector<std::pair<std::string, std::string>> entries;
+    if (head != "null" && !head.empty())
+        entries = readTree(readCommitTree(head), &filter);
+
+    std::unordered_set<std::string> inTree;
+    for (const auto& [filePath, blobHash] : entries) {
+        inTree.insert(filePath);
+
+        if (journal.valid && !journal.isDirty(filePath))
+            continue;
+
+        std::string fullPath = root + "/" + filePath;
+        if (!utils::exists(fullPath)) {
+            changes.push_back({ 'D', filePath });
+        } else if (utils::sha1(utils::read_file(fullPath)) != blobHash) {
+            changes.push_back({ 'M', filePath });
+        }
     }
+
+    // A tracked path that is neither in HEAD nor on disk has nothing to add
+    for (const auto& f : utils::read_lines(indexFile)) {
+        if (!inTree.count(f) && filter.matches(f) && utils::exists(root + "/" + f))
+            changes.push_back({ 'A', f });
+    }
+
+    return changes;
 }
 
+/**
+ * List tracked files that differ from HEAD
+ * @return Entries in tree order, then newly tracked files
+ */
+std::vector<StatusEntry> Repository::listChanges() {
+    if (!isInitialized()) return {};
+
+    std::string head = utils::read_file(vcsDir + "/HEAD");
+    return scanChanges(watcher::query(vcsDir, head));
+}
+
+void Repository::status() {
+    if (!isInitialized()) {
+        *out << "Error: not a LiteVCS repository.\n";
+        return;
+    }
 
+    auto changes = listChanges();
+
+    if (changes.empty()) {
+        *out << "Nothing changed since last save.\n";
+        return;
+    }
+
+    for (const auto& [type, path] : changes) {
+        if (type == 'M') *out << "modified: " << path << "\n";
+        else if (type == 'D') *out << "deleted:  " << path << "\n";
+        else *out << "new file: " << path << "\n";
+    }
+}
+
+void Repository::watch() {
+    if (!isInitialized()) {
+        *out << "Error: not a LiteVCS repository.\n";
+        return;
+    }
+
+    watcher::run(root, vcsDir, [this] {
+        std::vector<std::string> dirty;
+        for (const auto& change : scanChanges(watcher::Journal()))
+            dirty.push_back(change.path);
+        return dirty;
+    }, *out);
+}
+
+void Repository::stopWatch() {
+    if (!isInitialized()) {
+        *out << "Error: not a LiteVCS repository.\n";
+        return;
+    }
+
+    if (watcher::stop(vcsDir))
+        *out << "Watcher stopped.\n";
+    else
+        *out << "No watcher running.\n";
+}
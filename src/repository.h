@@ -1,58 +1,199 @@
 /**
  * LiteVCS Repository Header
- * 
+ *
  * Defines the Repository class for version control operations.
- * 
+ *
  * @author Puneeth R (GHOST)
  * @license MIT
  */
 
 #pragma once
+#include <ctime>
+#include <iostream>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+namespace watcher { struct Journal; }
+namespace txn { class WriteTransaction; enum class Durability; }
+namespace batchio { class BatchIO; }
+namespace pack { class PackSet; }
+namespace sparse { class Matcher; }
+
+/**
+ * Rename/copy detection settings for diff (-M / -C)
+ */
+struct RenameOptions {
+    bool detectRenames = false;
+    bool detectCopies = false;      // copies of modified or deleted files
+    bool copiesHarder = false;      // copies of any file in HEAD (reads every blob)
+    int threshold = 50;             // minimum similarity in percent
+};
+
+/**
+ * One commit from the history walk
+ */
+struct CommitInfo {
+    std::string hash;
+    std::string parent;     // "null" for the root commit
+    std::string tree;
+    std::time_t time = 0;
+    std::string message;
+};
+
+/**
+ * Run of consecutive changed lines
+ */
+struct DiffHunk {
+    int oldStart = 0;       // 1-based line in the committed file
+    int newStart = 0;       // 1-based line in the working file
+    std::vector<std::pair<char, std::string>> lines;   // ('+' | '-', text)
+};
+
+/**
+ * Changes to a single file relative to HEAD
+ */
+struct FileDiff {
+    enum class Kind { Modified, Deleted, Added, Renamed, Copied };
+
+    Kind kind = Kind::Modified;
+    std::string path;
+    std::string oldPath;    // source of a rename/copy
+    int similarity = 0;     // rename/copy score in percent
+    std::vector<DiffHunk> hunks;
+};
+
+/**
+ * Tracked file that differs from HEAD
+ */
+struct StatusEntry {
+    char type;              // 'M' modified, 'D' deleted, 'A' new
+    std::string path;
+};
+
+/**
+ * Outcome of a gc run
+ */
+struct GcStats {
+    bool ok = false;
+    std::string pack;       // pack written by this run, empty if none was needed
+    size_t reachable = 0;   // objects reachable from HEAD and refs
+    size_t packed = 0;      // objects written to the new pack
+    size_t pruned = 0;      // unreachable objects removed (loose or packed)
+    size_t kept = 0;        // unreachable objects still inside the grace period
+    long long bytesReclaimed = 0;   // object store size before minus after
+    double markMs = 0;
+    double packMs = 0;
+    double pruneMs = 0;
+};
+
 /**
  * Repository class - Core version control functionality
- * 
+ *
  * Manages initialization, file tracking, commits, history, and diffs.
+ * Messages and printed reports go to the output sink (std::cout by
+ * default); the list/compute methods return structured results instead.
  */
 class Repository {
 public:
-    explicit Repository(const std::string& rootPath);
+    explicit Repository(const std::string& rootPath,
+                        std::ostream& output = std::cout);
+    ~Repository();
+
+    void setOutput(std::ostream& output);
+    std::ostream& output() const { return *out; }
+    const std::string& rootPath() const { return root; }
 
     // Repository management
     bool isInitialized() const;
     void init();
-    
+    bool cloneTo(const std::string& destination, bool hardlinks = true);
+
     // File operations
-    void trackFile(const std::string& filePath);
-    void save(const std::string& message);
-    
+    bool trackFile(const std::string& filePath);
+    std::string save(const std::string& message);
+
     // History and navigation
+    std::vector<CommitInfo> listCommits();
     void showHistory();
-    void goToCommit(const std::string& commitHash);
-    
+    bool goToCommit(const std::string& commitHash);
+    bool goToCommit(const std::string& commitHash,
+                    const std::vector<std::string>& sparsePatterns);
+    std::vector<std::string> sparsePatterns();
+
     // Diff operations
-    void diff(bool ignoreEmpty, bool ignoreWhitespace);
+    std::vector<FileDiff> computeDiff(bool ignoreEmpty, bool ignoreWhitespace,
+                                      const RenameOptions& renames = RenameOptions());
+    void diff(bool ignoreEmpty, bool ignoreWhitespace,
+              const RenameOptions& renames = RenameOptions());
     void diffSmart(bool ignoreEmpty, bool ignoreWhitespace);
+    std::vector<StatusEntry> listChanges();
+    void status();
+
+    // Maintenance
+    GcStats collectGarbage(std::time_t grace);
+    void gc(std::time_t grace);
+
+    // Filesystem watcher (inotify daemon)
+    void watch();
+    void stopWatch();
+
 
-   
 private:
     std::string root;
     std::string vcsDir;
     std::string indexFile;
+    std::ostream* out;
+
+    // Decompressed objects by path; objects are immutable, so entries never go stale
+    std::unordered_map<std::string, std::string> objectCache;
+    size_t objectCacheBytes = 0;
 
-    std::string createBlob(const std::string& filePath);
+    // Bulk file I/O (io_uring or thread pool), created on first use
+    std::unique_ptr<batchio::BatchIO> io;
+
+    // Pack indexes, loaded on first use
+    std::unique_ptr<pack::PackSet> packSet;
+    long long packStamp = 0;    // pack directory mtime when loaded
+
+    batchio::BatchIO& batchIO();
+    const pack::PackSet& packs();
+    void reloadPacks();
+    void refreshPacks();
+    bool hasObject(const std::string& path);
+    bool reuseObject(const std::string& path);
+    bool readStoredObject(const std::string& path, std::string& compressed);
+    std::string createBlob(const std::string& content, txn::WriteTransaction& objects);
+    std::string configValue(const std::string& key);
+    void recordTip(const std::string& commit, const std::string& replaces,
+                   txn::Durability durability);
 
     std::string readObject(const std::string& path);
     std::string resolveCommitHash(const std::string& prefix);
+    bool checkout(const std::string& commitHash,
+                  const std::vector<std::string>* sparsePatterns);
+    sparse::Matcher sparseMatcher();
+    std::string readCommitTree(const std::string& commitHash);
+    std::vector<std::pair<std::string, std::string>>
+    readTree(const std::string& treeHash, const sparse::Matcher* filter = nullptr);
     std::vector<std::string> splitLines(const std::string& content);
-    
-    
+    std::vector<StatusEntry> scanChanges(const watcher::Journal& journal);
+
+
     std::string normalizeWhitespace(const std::string& s);
     std::string extractFunction(const std::string& line);
     bool isIgnorableLine(const std::string& line, bool ignoreEmpty, bool ignoreWhitespace);
-    std::vector<std::pair<char, std::string>>
+    std::vector<DiffHunk>
     lcsDiff(const std::vector<std::string>& a,
         const std::vector<std::string>& b);
+    void filterHunks(std::vector<DiffHunk>& hunks,
+                     bool ignoreEmpty, bool ignoreWhitespace);
+    void detectRenames(const std::vector<std::pair<std::string, std::string>>& entries,
+                       const std::vector<std::pair<std::string, std::string>>& deleted,
+                       const RenameOptions& renames,
+                       const sparse::Matcher& filter,
+                       bool ignoreEmpty, bool ignoreWhitespace,
+                       std::vector<FileDiff>& result);
+    void printFileDiff(const FileDiff& file);
 };
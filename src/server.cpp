@@ -0,0 +1,345 @@
+/**
+ * LiteVCS Server Mode Implementation
+ *
+ * Requests and responses are single JSON objects, one per line. Every
+ * response carries "ok", the captured human-readable "output", the
+ * request's "id" (if given) and op-specific fields:
+ *
+ *   {"op":"history"}                       -> "commits": [...]
+ *   {"op":"status"}                        -> "entries": [...]
+ *   {"op":"diff", "ignoreEmpty":true,
+ *    "ignoreWhitespace":false, "renames":true,
+ *    "copies":false, "copiesHarder":false,
+ *    "threshold":50}                       -> "files": [...]
+ *   {"op":"track", "path":"a.txt"}
+ *   {"op":"save", "message":"..."}         -> "commit": "<hash>"
+ *   {"op":"go", "commit":"<prefix>"}
+ *   {"op":"gc", "pruneDays":14}            -> "gc": {...}
+ *   {"op":"ping"} / {"op":"shutdown"}
+ *
+ * Clients are multiplexed with poll(); requests run one at a time.
+ *
+ * @author Puneeth R (GHOST)
+ * @license MIT
+ */
+
+#include "server.h"
+#include "repository.h"
+#include "ipc.h"
+#include "json.h"
+#include <sstream>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <csignal>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace server {
+
+namespace {
+
+    const char* kindName(FileDiff::Kind kind) {
+        switch (kind) {
+        case FileDiff::Kind::Modified: return "modified";
+        case FileDiff::Kind::Deleted: return "deleted";
+        case FileDiff::Kind::Added: return "added";
+        case FileDiff::Kind::Renamed: return "renamed";
+        case FileDiff::Kind::Copied: return "copied";
+        }
+        return "modified";
+    }
+
+    const char* statusName(char type) {
+        switch (type) {
+        case 'M': return "modified";
+        case 'D': return "deleted";
+        default: return "new";
+        }
+    }
+
+    void writeCommits(std::ostream& os, const std::vector<CommitInfo>& commits) {
+        os << "\"commits\":[";
+        for (size_t i = 0; i < commits.size(); ++i) {
+            const auto& c = commits[i];
+            if (i) os << ",";
+            os << "{\"hash\":" << json::quote(c.hash)
+               << ",\"parent\":" << json::quote(c.parent)
+               << ",\"tree\":" << json::quote(c.tree)
+               << ",\"time\":" << static_cast<long long>(c.time)
+               << ",\"message\":" << json::quote(c.message) << "}";
+        }
+        os << "]";
+    }
+
+    void writeStatus(std::ostream& os, const std::vector<StatusEntry>& entries) {
+        os << "\"entries\":[";
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (i) os << ",";
+            os << "{\"type\":\"" << statusName(entries[i].type) << "\""
+               << ",\"path\":" << json::quote(entries[i].path) << "}";
+        }
+        os << "]";
+    }
+
+    void writeDiff(std::ostream& os, const std::vector<FileDiff>& files) {
+        os << "\"files\":[";
+        for (size_t i = 0; i < files.size(); ++i) {
+            const auto& f = files[i];
+            if (i) os << ",";
+            os << "{\"kind\":\"" << kindName(f.kind) << "\""
+               << ",\"path\":" << json::quote(f.path);
+            if (!f.oldPath.empty()) {
+                os << ",\"oldPath\":" << json::quote(f.oldPath)
+                   << ",\"similarity\":" << f.similarity;
+            }
+            os << ",\"hunks\":[";
+            for (size_t h = 0; h < f.hunks.size(); ++h) {
+                const auto& hunk = f.hunks[h];
+                if (h) os << ",";
+                os << "{\"oldStart\":" << hunk.oldStart
+                   << ",\"newStart\":" << hunk.newStart << ",\"lines\":[";
+                for (size_t l = 0; l < hunk.lines.size(); ++l) {
+                    if (l) os << ",";
+                    os << "{\"type\":\"" << hunk.lines[l].first << "\""
+                       << ",\"text\":" << json::quote(hunk.lines[l].second) << "}";
+                }
+                os << "]}";
+            }
+            os << "]}";
+        }
+        os << "]";
+    }
+}
+
+std::string handleRequest(Repository& repo, const std::string& request) {
+    std::unordered_map<std::string, std::string> req;
+    std::string error;
+
+    if (!json::parseObject(request, req, error))
+        return "{\"ok\":false,\"error\":" + json::quote("bad request: " + error) + "}";
+
+    auto flag = [&](const char* key) {
+        auto it = req.find(key);
+        return it != req.end() && it->second == "true";
+    };
+
+    // Capture messages for this request only
+    std::ostream& previous = repo.output();
+    std::ostringstream captured;
+    repo.setOutput(captured);
+
+    std::ostringstream body;
+    bool ok = true;
+    const std::string& op = req["op"];
+
+    try {
+        if (op != "ping" && op != "shutdown" && !repo.isInitialized()) {
+            ok = false;
+            error = "not a LiteVCS repository";
+        }
+        else if (op == "ping" || op == "shutdown") {
+            // nothing to do; the serve loop handles shutdown
+        }
+        else if (op == "history") {
+            writeCommits(body, repo.listCommits());
+        }
+        else if (op == "status") {
+            writeStatus(body, repo.listChanges());
+        }
+        else if (op == "diff") {
+            RenameOptions renames;
+            renames.copiesHarder = flag("copiesHarder");
+            renames.detectCopies = flag("copies") || renames.copiesHarder;
+            renames.detectRenames = flag("renames") || renames.detectCopies;
+            if (req.count("threshold")) {
+                // Same 0-100 range the CLI enforces for -M<n> / -C<n>
+                const std::string& value = req["threshold"];
+                bool valid = !value.empty() && value.size() <= 3 &&
+                             value.find_first_not_of("0123456789") == std::string::npos;
+                if (valid) renames.threshold = std::stoi(value);
+                if (!valid || renames.threshold > 100) {
+                    ok = false;
+                    error = "similarity threshold must be 0-100";
+                }
+            }
+
+            if (ok) {
+                writeDiff(body, repo.computeDiff(flag("ignoreEmpty"),
+                                                 flag("ignoreWhitespace"), renames));
+            }
+        }
+        else if (op == "track") {
+            ok = repo.trackFile(req["path"]);
+        }
+        else if (op == "save") {
+            std::string commit = repo.save(req["message"]);
+            ok = !commit.empty();
+            if (ok) body << "\"commit\":" << json::quote(commit);
+        }
+        else if (op == "go") {
+            ok = repo.goToCommit(req["commit"]);
+        }
+        else if (op == "gc") {
+            // Same rule as the CLI's --prune=: a number of days, or "now"
+            std::time_t days = 14;
+            if (req.count("pruneDays")) {
+                const std::string& value = req["pruneDays"];
+                bool valid = !value.empty() && value.size() <= 5 &&
+                             value.find_first_not_of("0123456789") == std::string::npos;
+                if (value == "now") days = 0;
+                else if (valid) days = std::stoi(value);
+                else {
+                    ok = false;
+                    error = "pruneDays takes a number of days or 'now'";
+                }
+            }
+
+            GcStats stats;
+            if (ok) {
+                stats = repo.collectGarbage(days * 24 * 60 * 60);
+                ok = stats.ok;
+            }
+            if (ok) {
+                body << "\"gc\":{\"reachable\":" << stats.reachable
+                     << ",\"packed\":" << stats.packed
+                     << ",\"pruned\":" << stats.pruned
+                     << ",\"kept\":" << stats.kept
+                     << ",\"bytesReclaimed\":" << stats.bytesReclaimed
+                     << ",\"markMs\":" << stats.markMs
+                     << ",\"packMs\":" << stats.packMs
+                     << ",\"pruneMs\":" << stats.pruneMs << "}";
+            }
+        }
+        else {
+            ok = false;
+            error = "unknown op: " + op;
+        }
+    } catch (const std::exception& e) {
+        ok = false;
+        error = e.what();
+    }
+
+    repo.setOutput(previous);
+
+    std::ostringstream response;
+    response << "{\"ok\":" << (ok ? "true" : "false");
+    if (req.count("id")) response << ",\"id\":" << json::quote(req["id"]);
+    if (!error.empty()) response << ",\"error\":" << json::quote(error);
+    response << ",\"output\":" << json::quote(captured.str());
+
+    std::string fields = body.str();
+    if (!fields.empty()) response << "," << fields;
+    response << "}";
+    return response.str();
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+
+namespace {
+
+    // A client still sending a single request beyond this is dropped
+    const size_t MAX_REQUEST_BYTES = 1 << 20;
+
+    volatile std::sig_atomic_t stopRequested = 0;
+
+    void onSignal(int) {
+        stopRequested = 1;
+    }
+
+    bool isShutdown(const std::string& request) {
+        std::unordered_map<std::string, std::string> req;
+        std::string error;
+        return json::parseObject(request, req, error) && req["op"] == "shutdown";
+    }
+}
+
+int run(Repository& repo, const std::string& socketPath) {
+    if (!repo.isInitialized()) {
+        repo.output() << "Error: not a LiteVCS repository.\n";
+        return 1;
+    }
+
+    int listenFd = ipc::listenUnix(socketPath);
+    if (listenFd < 0) {
+        repo.output() << "Error: cannot listen on " << socketPath << "\n";
+        return 1;
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    repo.output() << "Serving " << repo.rootPath() << " on " << socketPath << "\n";
+    repo.output().flush();
+
+    std::vector<std::unique_ptr<ipc::Connection>> clients;
+    bool running = true;
+
+    while (running && !stopRequested) {
+        std::vector<pollfd> fds;
+        fds.push_back({ listenFd, POLLIN, 0 });
+        for (const auto& c : clients)
+            fds.push_back({ c->descriptor(), POLLIN, 0 });
+
+        int ready = ::poll(fds.data(), fds.size(), 500);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        // Serve existing clients first; fds[i + 1] belongs to clients[i].
+        // Reads never block: partial requests stay buffered until complete.
+        std::vector<bool> closed(clients.size(), false);
+        for (size_t i = 0; i < clients.size() && running; ++i) {
+            if (!(fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+
+            bool open = clients[i]->receive();
+
+            std::string line;
+            while (running && clients[i]->nextLine(line)) {
+                if (line.empty()) continue;
+
+                if (!clients[i]->send(handleRequest(repo, line) + "\n")) {
+                    open = false;
+                    break;
+                }
+                if (isShutdown(line)) running = false;
+            }
+
+            if (!open || clients[i]->buffered() > MAX_REQUEST_BYTES) closed[i] = true;
+        }
+
+        for (size_t i = clients.size(); i-- > 0; ) {
+            if (closed[i]) clients.erase(clients.begin() + i);
+        }
+
+        if (running && (fds[0].revents & POLLIN)) {
+            int fd = ipc::acceptClient(listenFd);
+            if (fd >= 0 && ipc::setNonBlocking(fd))
+                clients.push_back(std::make_unique<ipc::Connection>(fd));
+            else
+                ipc::closeSocket(fd);
+        }
+    }
+
+    clients.clear();
+    ipc::closeSocket(listenFd);
+    ::unlink(socketPath.c_str());
+    repo.output() << "Server stopped\n";
+    return 0;
+}
+
+#else
+
+int run(Repository& repo, const std::string&) {
+    repo.output() << "Error: server mode requires Unix domain sockets\n";
+    return 1;
+}
+
+#endif
+
+}
@@ -0,0 +1,32 @@
+/**
+ * LiteVCS Server Mode Header
+ *
+ * Keeps one Repository open (with its warm object cache) and answers
+ * newline-delimited JSON requests over a Unix domain socket, so tools can
+ * drive LiteVCS without paying process start-up per operation.
+ *
+ * @author Puneeth R (GHOST)
+ * @license MIT
+ */
+
+#pragma once
+#include <string>
+
+class Repository;
+
+namespace server {
+
+    /**
+     * Execute one JSON request against the repository
+     * @param request e.g. {"op":"diff","renames":true,"id":"7"}
+     * @return Single-line JSON response
+     */
+    std::string handleRequest(Repository& repo, const std::string& request);
+
+    /**
+     * Serve requests until a "shutdown" request or SIGINT/SIGTERM
+     * Status messages go to the repository's output stream.
+     * @return Process exit code
+     */
+    int run(Repository& repo, const std::string& socketPath);
+}
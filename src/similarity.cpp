@@ -0,0 +1,100 @@
+/**
+ * LiteVCS Similarity Sketches Implementation
+ *
+ * Each slot applies a different cheap permutation (xor with a seed, then a
+ * 64-bit finalizer) to the line hashes and keeps the minimum. A line is
+ * hashed together with its occurrence number, so the k-th copy of a line
+ * is its own element and repeated lines count as often as they appear.
+ * The fraction of slots on which two sketches agree estimates the Jaccard
+ * similarity of the underlying line multisets.
+ *
+ * @author Puneeth R (GHOST)
+ * @license MIT
+ */
+
+#include "similarity.h"
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+namespace similarity {
+
+namespace {
+
+    // splitmix64 finalizer - good avalanche, no state
+    uint64_t mix(uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    const std::array<uint64_t, SKETCH_SIZE>& seeds() {
+        static const std::array<uint64_t, SKETCH_SIZE> table = [] {
+            std::array<uint64_t, SKETCH_SIZE> s{};
+            uint64_t state = 0x9e3779b97f4a7c15ULL;
+            for (auto& seed : s) {
+                state += 0x9e3779b97f4a7c15ULL;
+                seed = mix(state);
+            }
+            return s;
+        }();
+        return table;
+    }
+}
+
+uint64_t hashLine(const std::string& line) {
+    // FNV-1a, 64 bit
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (unsigned char c : line) {
+        h ^= c;
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+Sketch build(const std::vector<std::string>& lines) {
+    Sketch sketch;
+    sketch.mins.fill(std::numeric_limits<uint64_t>::max());
+    sketch.lineCount = lines.size();
+    sketch.empty = lines.empty();
+
+    const auto& s = seeds();
+    std::unordered_map<uint64_t, uint64_t> seen;
+    seen.reserve(lines.size());
+    for (const auto& line : lines) {
+        uint64_t base = hashLine(line);
+        uint64_t h = mix(base ^ mix(seen[base]++));
+        for (size_t i = 0; i < SKETCH_SIZE; ++i) {
+            uint64_t v = mix(h ^ s[i]);
+            if (v < sketch.mins[i]) sketch.mins[i] = v;
+        }
+    }
+    return sketch;
+}
+
+double estimate(const Sketch& a, const Sketch& b) {
+    if (a.empty || b.empty) {
+        return (a.empty && b.empty) ? 1.0 : 0.0;
+    }
+
+    size_t agree = 0;
+    for (size_t i = 0; i < SKETCH_SIZE; ++i) {
+        if (a.mins[i] == b.mins[i]) agree++;
+    }
+    return static_cast<double>(agree) / SKETCH_SIZE;
+}
+
+double minimumEstimate(int thresholdPercent) {
+    // With c common lines, score s = c / max(n, m). The multisets share at
+    // least those c lines, so J >= c / (n + m - c) >= s / (2 - s); anything
+    // below that bound (minus the sketch's estimation error) cannot reach
+    // the threshold.
+    double s = std::clamp(thresholdPercent, 0, 100) / 100.0;
+    double bound = s / (2.0 - s);
+    return std::max(0.0, bound - 0.1);
+}
+
+}
@@ -0,0 +1,48 @@
+/**
+ * LiteVCS Similarity Sketches
+ *
+ * MinHash sketches over line hashes, used by rename/copy detection to
+ * shortlist candidate file pairs before running the full LCS diff.
+ *
+ * @author Puneeth R (GHOST)
+ * @license MIT
+ */
+
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace similarity {
+
+    // Number of independent min-hash slots per sketch.
+    // 64 slots keep the Jaccard estimate within roughly +/-0.06.
+    constexpr size_t SKETCH_SIZE = 64;
+
+    /**
+     * Fixed-size summary of a file's lines, repeats included
+     */
+    struct Sketch {
+        std::array<uint64_t, SKETCH_SIZE> mins;
+        size_t lineCount = 0;
+        bool empty = true;
+    };
+
+    uint64_t hashLine(const std::string& line);
+
+    Sketch build(const std::vector<std::string>& lines);
+
+    /**
+     * Estimate the Jaccard similarity of the two line multisets
+     * @return Value in [0, 1]
+     */
+    double estimate(const Sketch& a, const Sketch& b);
+
+    /**
+     * Smallest Jaccard estimate that can still reach the given line
+     * similarity score (common / max(lines)), including estimation slack
+     * @param thresholdPercent Minimum similarity in percent (0-100)
+     */
+    double minimumEstimate(int thresholdPercent);
+}
@@ -0,0 +1,136 @@
+/**
+ * LiteVCS Sparse Checkout Implementation
+ *
+ * @author Puneeth R (GHOST)
+ * @license MIT
+ */
+
+#include "sparse.h"
+#include "transaction.h"
+#include "utils.h"
+#include <filesystem>
+
+namespace sparse {
+
+namespace {
+
+    const char* PATTERN_FILE = "/sparse-checkout";
+
+    std::string normalize(std::string pattern) {
+        size_t start = pattern.find_first_not_of(" \t");
+        if (start == std::string::npos) return "";
+        pattern = pattern.substr(start, pattern.find_last_not_of(" \t\r") - start + 1);
+
+        while (pattern.rfind("./", 0) == 0) pattern.erase(0, 2);
+        while (!pattern.empty() && pattern.front() == '/') pattern.erase(0, 1);
+        while (!pattern.empty() && pattern.back() == '/') pattern.pop_back();
+        return pattern;
+    }
+
+    /**
+     * '*' and '?' stop at '/'; '**' does not, and "**" + "/" may match nothing
+     */
+    bool glob(const std::string& p, size_t pi, const std::string& s, size_t si) {
+        while (pi < p.size()) {
+            char c = p[pi];
+
+            if (c == '*') {
+                bool crossing = pi + 1 < p.size() && p[pi + 1] == '*';
+                while (pi < p.size() && p[pi] == '*') pi++;
+
+                if (crossing && pi < p.size() && p[pi] == '/' && glob(p, pi + 1, s, si))
+                    return true;
+
+                for (size_t k = si; k <= s.size(); ++k) {
+                    if (glob(p, pi, s, k)) return true;
+                    if (k < s.size() && s[k] == '/' && !crossing) break;
+                }
+                return false;
+            }
+
+            if (si >= s.size()) return false;
+            if (c == '?' ? s[si] == '/' : c != s[si]) return false;
+            pi++;
+            si++;
+        }
+        return si == s.size();
+    }
+}
+
+Matcher::Matcher(const std::vector<std::string>& input) {
+    for (const auto& raw : input) {
+        std::string pattern = normalize(raw);
+        if (pattern.empty() || pattern[0] == '#') continue;
+
+        patterns.push_back(pattern);
+        if (pattern.find_first_of("*?") == std::string::npos) {
+            if (pattern.find('/') == std::string::npos) names.insert(pattern);
+            else literals.insert(pattern);
+        } else
+            globs.push_back({ pattern, pattern.find('/') == std::string::npos });
+    }
+}
+
+/**
+ * Does a tree path fall under any pattern?
+ * A pattern naming a directory matches every path below it.
+ */
+bool Matcher::matches(const std::string& path) const {
+    if (patterns.empty()) return true;
+
+    if (!literals.empty()) {
+        if (literals.count(path)) return true;
+        for (size_t pos = path.find('/'); pos != std::string::npos;
+             pos = path.find('/', pos + 1)) {
+            if (literals.count(path.substr(0, pos))) return true;
+        }
+    }
+
+    if (!names.empty()) {
+        size_t begin = 0;
+        while (true) {
+            size_t end = path.find('/', begin);
+            if (names.count(path.substr(begin, end - begin))) return true;
+            if (end == std::string::npos) break;
+            begin = end + 1;
+        }
+    }
+
+    for (const auto& g : globs) {
+        size_t begin = 0;
+        while (true) {
+            size_t end = path.find('/', begin);
+            bool last = end == std::string::npos;
+            if (last) end = path.size();
+
+            bool hit = g.anyLevel
+                ? glob(g.pattern, 0, path.substr(begin, end - begin), 0)
+                : glob(g.pattern, 0, path.substr(0, end), 0);
+            if (hit) return true;
+
+            if (last) break;
+            begin = end + 1;
+        }
+    }
+    return false;
+}
+
+std::vector<std::string> load(const std::string& vcsDir) {
+    return utils::read_lines(vcsDir + PATTERN_FILE);
+}
+
+void store(const std::string& vcsDir, const std::vector<std::string>& patterns,
+           txn::Durability durability) {
+    std::string path = vcsDir + PATTERN_FILE;
+    if (patterns.empty()) {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        return;
+    }
+
+    std::string data;
+    for (const auto& p : patterns) data += p + "\n";
+    txn::replaceFile(path, data, durability);
+}
+
+}
@@ -0,0 +1,68 @@
+/**
+ * LiteVCS Sparse Checkout
+ *
+ * Path patterns limiting which tree entries checkout, diff, status and save
+ * look at. Patterns live in .vcs/sparse-checkout, one per line ('#' starts a
+ * comment); an absent or empty file means the whole tree.
+ *
+ *   src/net          the file or directory src/net and everything below it
+ *   docs/api-*.md    '*' and '?' match within one path component
+ *   src/net**.c      '**' also matches across components
+ *   *.proto          a pattern without '/' matches any file or directory name
+ *
+ * @author Puneeth R (GHOST)
+ * @license MIT
+ */
+
+#pragma once
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace txn { enum class Durability; }
+
+namespace sparse {
+
+    /**
+     * Patterns compiled for repeated matching during a tree walk
+     * Literal paths become a hash set probed once per directory level, and
+     * literal names one probed once per path component; only patterns
+     * with wildcards fall back to glob matching.
+     */
+    class Matcher {
+    public:
+        Matcher() = default;
+        explicit Matcher(const std::vector<std::string>& patterns);
+
+        /**
+         * True when no patterns are set, i.e. everything matches
+         */
+        bool empty() const { return patterns.empty(); }
+
+        bool matches(const std::string& path) const;
+
+        const std::vector<std::string>& source() const { return patterns; }
+
+    private:
+        struct Glob {
+            std::string pattern;
+            bool anyLevel;      // no '/' in the pattern: test each name
+        };
+
+        std::vector<std::string> patterns;
+        std::unordered_set<std::string> literals;
+        std::unordered_set<std::string> names;     // no '/': any component
+        std::vector<Glob> globs;
+    };
+
+    /**
+     * Read the patterns in .vcs/sparse-checkout
+     */
+    std::vector<std::string> load(const std::string& vcsDir);
+
+    /**
+     * Atomically replace .vcs/sparse-checkout; an empty list removes it
+     */
+    void store(const std::string& vcsDir, const std::vector<std::string>& patterns,
+               txn::Durability durability);
+}
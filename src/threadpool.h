@@ -0,0 +1,52 @@
+/**
+ * LiteVCS Thread Pool
+ *
+ * Fixed set of worker threads draining a shared task queue. Used for
+ * CPU work (hashing, compression) and as the portable bulk I/O backend.
+ *
+ * @author Puneeth R (GHOST)
+ * @license MIT
+ */
+
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    /**
+     * @param threads Worker count; 0 picks one per hardware thread
+     */
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+
+    /**
+     * Block until every submitted task has finished
+     * Rethrows the first exception thrown by a task since the last wait().
+     */
+    void wait();
+
+    size_t size() const { return workers.size(); }
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable available;
+    std::condition_variable idle;
+    size_t active = 0;
+    bool stopping = false;
+    std::exception_ptr error;
+
+    void workerLoop();
+};
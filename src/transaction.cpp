@@ -0,0 +1,275 @@
+/**
+ * LiteVCS Write Transactions Implementation
+ *
+ * Batch mode is a group commit: all objects are written without syncing
+ * (in parallel when a BatchIO is supplied), then a single syncfs() flushes
+ * them together before any rename. On systems without syncfs each staged
+ * file is fdatasync'ed at commit time, which still lets the kernel overlap
+ * the writeback of the whole batch.
+ *
+ * @author Puneeth R (GHOST)
+ * @license MIT
+ */
+
+#include "transaction.h"
+#include "batchio.h"
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define LITEVCS_POSIX_IO 1
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace txn {
+
+namespace {
+
+    std::atomic<unsigned long> tempCounter{ 0 };
+
+    std::string tempName(const std::string& target) {
+#ifdef LITEVCS_POSIX_IO
+        long pid = static_cast<long>(::getpid());
+#else
+        long pid = 0;
+#endif
+        return target + ".tmp-" + std::to_string(pid) + "-" +
+               std::to_string(tempCounter++);
+    }
+
+    std::string parentDir(const std::string& path) {
+        std::string parent = std::filesystem::path(path).parent_path().string();
+        return parent.empty() ? "." : parent;
+    }
+
+#ifdef LITEVCS_POSIX_IO
+
+    [[noreturn]] void fail(const std::string& what, const std::string& path) {
+        throw std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+    }
+
+    int dataSync(int fd) {
+#if defined(__APPLE__)
+        return ::fsync(fd);
+#else
+        return ::fdatasync(fd);
+#endif
+    }
+
+    void writeFile(const std::string& path, const std::string& data, bool sync) {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        if (fd < 0) fail("cannot create", path);
+
+        size_t written = 0;
+        while (written < data.size()) {
+            ssize_t n = ::write(fd, data.data() + written, data.size() - written);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                int saved = errno;
+                ::close(fd);
+                errno = saved;
+                fail("write failed for", path);
+            }
+            written += static_cast<size_t>(n);
+        }
+
+        if (sync && dataSync(fd) < 0) {
+            int saved = errno;
+            ::close(fd);
+            errno = saved;
+            fail("sync failed for", path);
+        }
+        if (::close(fd) < 0) fail("close failed for", path);
+    }
+
+    void syncPath(const std::string& path, bool directory) {
+        int fd = ::open(path.c_str(), (directory ? O_RDONLY | O_DIRECTORY : O_RDONLY) | O_CLOEXEC);
+        if (fd < 0) fail("cannot open", path);
+        int res = directory ? ::fsync(fd) : dataSync(fd);
+        int saved = errno;
+        ::close(fd);
+        if (res < 0) {
+            errno = saved;
+            fail("sync failed for", path);
+        }
+    }
+
+    void syncFilesystem(const std::vector<std::string>& files) {
+#ifdef __linux__
+        int fd = ::open(files.front().c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) fail("cannot open", files.front());
+        int res = ::syncfs(fd);
+        int saved = errno;
+        ::close(fd);
+        if (res == 0) return;
+        errno = saved;
+        if (errno != ENOSYS) fail("syncfs failed for", files.front());
+#endif
+        for (const auto& f : files) syncPath(f, false);
+    }
+
+    void renameFile(const std::string& from, const std::string& to) {
+        if (::rename(from.c_str(), to.c_str()) < 0) fail("cannot rename", from);
+    }
+
+    void removeFile(const std::string& path) {
+        ::unlink(path.c_str());
+    }
+
+#else
+
+    void writeFile(const std::string& path, const std::string& data, bool) {
+        std::ofstream out(path, std::ios::binary);
+        out.write(data.data(), data.size());
+        out.close();
+        if (!out) throw std::runtime_error("write failed for " + path);
+    }
+
+    void syncPath(const std::string&, bool) {}
+    void syncFilesystem(const std::vector<std::string>&) {}
+
+    void renameFile(const std::string& from, const std::string& to) {
+        std::error_code ec;
+        std::filesystem::rename(from, to, ec);
+        if (ec) throw std::runtime_error("cannot rename " + from + ": " + ec.message());
+    }
+
+    void removeFile(const std::string& path) {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+
+#endif
+}
+
+Durability parseDurability(const std::string& value) {
+    if (value == "none") return Durability::None;
+    if (value == "full") return Durability::Full;
+    return Durability::Batch;
+}
+
+const char* durabilityName(Durability durability) {
+    switch (durability) {
+    case Durability::None: return "none";
+    case Durability::Full: return "full";
+    case Durability::Batch: break;
+    }
+    return "batch";
+}
+
+WriteTransaction::WriteTransaction(Durability durability, batchio::BatchIO* io)
+    : durability(durability), io(io) {}
+
+WriteTransaction::~WriteTransaction() {
+    if (committed) return;
+    for (const auto& p : pending) removeFile(p.temp);
+}
+
+void WriteTransaction::stage(const std::string& path, std::string data) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (committed) throw std::logic_error("transaction already committed");
+    if (!targets.insert(path).second) return;
+
+    bufferedBytes += data.size();
+    pending.push_back({ tempName(path), path, std::move(data) });
+
+    if (bufferedBytes > FLUSH_BYTES) flushLocked();
+}
+
+/**
+ * Write every buffered object to its temp file and release the memory
+ * Runs on the staging thread with plain writes: the BatchIO may be busy
+ * with the reads that are producing these objects.
+ */
+void WriteTransaction::flushLocked() {
+    bool syncEach = durability == Durability::Full;
+    for (auto& p : pending) {
+        if (p.written) continue;
+        writeFile(p.temp, p.data, syncEach);
+        std::string().swap(p.data);
+        p.written = true;
+    }
+    bufferedBytes = 0;
+}
+
+void WriteTransaction::commit() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (committed) return;
+
+    bool syncEach = durability == Durability::Full;
+
+    if (io) {
+        std::vector<batchio::WriteRequest> requests;
+        requests.reserve(pending.size());
+        for (auto& p : pending) {
+            if (!p.written)
+                requests.push_back({ p.temp, std::move(p.data), true, syncEach });
+        }
+
+        auto results = io->writeFiles(requests);
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (results[i] != 0) {
+                throw std::runtime_error("cannot write " + requests[i].path + ": " +
+                                         std::generic_category().message(results[i]));
+            }
+        }
+    } else {
+        for (auto& p : pending) {
+            if (p.written) continue;
+            writeFile(p.temp, p.data, syncEach);
+            std::string().swap(p.data);
+        }
+    }
+
+    if (durability == Durability::Batch && !pending.empty()) {
+        std::vector<std::string> temps;
+        for (const auto& p : pending) temps.push_back(p.temp);
+        syncFilesystem(temps);
+    }
+
+    std::unordered_set<std::string> dirs;
+    for (const auto& p : pending) {
+        renameFile(p.temp, p.target);
+        dirs.insert(parentDir(p.target));
+    }
+    committed = true;
+
+    // Persist the new directory entries
+    if (durability != Durability::None) {
+        for (const auto& d : dirs) syncPath(d, true);
+    }
+}
+
+std::string tempPath(const std::string& target) {
+    return tempName(target);
+}
+
+void commitFile(const std::string& temp, const std::string& path,
+                Durability durability) {
+    if (durability != Durability::None) syncPath(temp, false);
+    renameFile(temp, path);
+    if (durability != Durability::None) syncPath(parentDir(path), true);
+}
+
+void replaceFile(const std::string& path, const std::string& data,
+                 Durability durability) {
+    std::string temp = tempName(path);
+    try {
+        writeFile(temp, data, durability != Durability::None);
+        renameFile(temp, path);
+    } catch (...) {
+        removeFile(temp);
+        throw;
+    }
+
+    if (durability != Durability::None)
+        syncPath(parentDir(path), true);
+}
+
+}
@@ -0,0 +1,109 @@
+/**
+ * LiteVCS Write Transactions
+ *
+ * Crash-safe object writes. Objects are staged into temporary files and
+ * only renamed into place once they are durable, so a crash can never
+ * leave a truncated object under its final name. HEAD is replaced with an
+ * atomic rename after the objects it points at are safe.
+ *
+ * @author Puneeth R (GHOST)
+ * @license MIT
+ */
+
+#pragma once
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace batchio { class BatchIO; }
+
+namespace txn {
+
+    /**
+     * How hard commit() works to survive power loss (config key "durability")
+     */
+    enum class Durability {
+        None,   // atomic renames only, no syncs
+        Batch,  // one filesystem-wide sync per transaction (default)
+        Full    // fdatasync every object as it is written
+    };
+
+    /**
+     * Parse "none" | "batch" | "full"; anything else yields Batch
+     */
+    Durability parseDurability(const std::string& value);
+    const char* durabilityName(Durability durability);
+
+    /**
+     * Group of object writes made visible together
+     *
+     * Staged data is buffered and written as one batch by commit(), through
+     * the given BatchIO if any. Once the buffered data passes FLUSH_BYTES,
+     * stage() writes it out to the temp files so memory stays bounded;
+     * nothing is renamed into place before commit(). stage() may be called
+     * from several threads.
+     * Errors are reported with std::runtime_error. Staged files that were
+     * never committed are removed when the transaction is destroyed.
+     */
+    class WriteTransaction {
+    public:
+        static const size_t FLUSH_BYTES = 32 * 1024 * 1024;
+
+        explicit WriteTransaction(Durability durability,
+                                  batchio::BatchIO* io = nullptr);
+        ~WriteTransaction();
+
+        WriteTransaction(const WriteTransaction&) = delete;
+        WriteTransaction& operator=(const WriteTransaction&) = delete;
+
+        /**
+         * Queue data for a temporary file next to `path`
+         * Staging the same path twice is a no-op (objects are content-addressed).
+         */
+        void stage(const std::string& path, std::string data);
+
+        /**
+         * Make every staged file durable and move it into place
+         */
+        void commit();
+
+        size_t size() const { return pending.size(); }
+
+    private:
+        struct Pending {
+            std::string temp;
+            std::string target;
+            std::string data;
+            bool written = false;   // flushed to the temp file by stage()
+        };
+
+        void flushLocked();
+
+        Durability durability;
+        batchio::BatchIO* io;
+        std::mutex mutex;
+        std::vector<Pending> pending;
+        std::unordered_set<std::string> targets;
+        size_t bufferedBytes = 0;
+        bool committed = false;
+    };
+
+    /**
+     * Name for a temporary file next to target (target + ".tmp-<pid>-<n>")
+     */
+    std::string tempPath(const std::string& target);
+
+    /**
+     * Make a fully written temp file durable and rename it over path
+     * Used by writers that stream a large file instead of staging it.
+     */
+    void commitFile(const std::string& temp, const std::string& path,
+                    Durability durability);
+
+    /**
+     * Atomically replace a small file (HEAD) via temp file + rename
+     */
+    void replaceFile(const std::string& path, const std::string& data,
+                     Durability durability);
+}
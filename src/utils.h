@@ -7,6 +7,7 @@
 #include <openssl/sha.h>
 #include <zlib.h>
 #include <filesystem>
+#include <algorithm>
 
 namespace utils {
 
@@ -63,6 +64,25 @@ namespace utils {
         return std::string(reinterpret_cast<char*>(buffer.data()), compressedSize);
     }
 
+    /**
+     * Inflate a stored object
+     * @param out Receives the content on success
+     * @return zlib status; Z_BUF_ERROR means it exceeds the size limit
+     */
+    inline int decompress(const std::string& data, std::string& out) {
+        // Security: Prevent decompression bombs by limiting output size
+        const uLongf MAX_DECOMPRESSED_SIZE = 100 * 1024 * 1024; // 100 MB limit
+        uLongf outCap = std::min(static_cast<uLongf>(data.size() * 6 + 64), MAX_DECOMPRESSED_SIZE);
+        std::vector<Bytef> buffer(outCap);
+
+        int res = ::uncompress(buffer.data(), &outCap,
+                               reinterpret_cast<const Bytef*>(data.data()),
+                               data.size());
+        if (res == Z_OK)
+            out.assign(reinterpret_cast<char*>(buffer.data()), outCap);
+        return res;
+    }
+
     inline void write_binary(const std::string& path, const std::string& data) {
         std::ofstream out(path, std::ios::binary);
         out.write(data.data(), data.size());
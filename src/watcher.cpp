@@ -0,0 +1,409 @@
+/**
+ * LiteVCS Filesystem Watcher Implementation
+ *
+ * Protocol (one request per connection, '\n'-terminated lines):
+ *   QUERY                 -> "OK <seq> <head>" or "OVERFLOW <seq> <head>",
+ *                            then "P <path>" per dirty path, then "END"
+ *                            (paths escape '\\' as "\\\\" and newline as "\\n")
+ *   RESET <seq> <head>    -> "OK"; forgets events up to <seq>
+ *   STOP                  -> "OK"; daemon exits
+ *
+ * Pending inotify events are drained before every answer, so a write that
+ * completed before the client connected is always in the reply.
+ *
+ * @author Puneeth R (GHOST)
+ * @license MIT
+ */
+
+#include "watcher.h"
+#include "ipc.h"
+#include "utils.h"
+#include <ostream>
+#include <sstream>
+#include <filesystem>
+#include <unordered_map>
+
+#ifdef __linux__
+#include <cerrno>
+#include <csignal>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace watcher {
+
+namespace {
+
+    // Clients give up on an unresponsive daemon and scan instead
+    const int CLIENT_TIMEOUT_MS = 2000;
+
+    std::string socketPath(const std::string& vcsDir) {
+        return vcsDir + "/watcher.sock";
+    }
+
+    std::string escapePath(const std::string& path) {
+        std::string escaped;
+        for (char c : path) {
+            if (c == '\\') escaped += "\\\\";
+            else if (c == '\n') escaped += "\\n";
+            else escaped += c;
+        }
+        return escaped;
+    }
+
+    bool unescapePath(const std::string& escaped, std::string& path) {
+        path.clear();
+        for (size_t i = 0; i < escaped.size(); ++i) {
+            if (escaped[i] != '\\') {
+                path += escaped[i];
+                continue;
+            }
+            if (++i == escaped.size()) return false;
+            if (escaped[i] == '\\') path += '\\';
+            else if (escaped[i] == 'n') path += '\n';
+            else return false;
+        }
+        return true;
+    }
+}
+
+bool Journal::isDirty(const std::string& path) const {
+    if (dirty.count(path)) return true;
+
+    // A touched directory (created, moved, deleted) covers everything below it
+    for (size_t pos = path.find('/'); pos != std::string::npos;
+         pos = path.find('/', pos + 1)) {
+        if (dirty.count(path.substr(0, pos))) return true;
+    }
+    return false;
+}
+
+Journal query(const std::string& vcsDir, const std::string& head) {
+    Journal journal;
+
+    ipc::Connection conn(ipc::connectUnix(socketPath(vcsDir), CLIENT_TIMEOUT_MS));
+    if (!conn.valid() || !conn.send("QUERY\n")) return journal;
+
+    std::string line;
+    if (!conn.readLine(line)) return journal;
+
+    std::istringstream status(line);
+    std::string state, journalHead;
+    status >> state >> journal.sequence >> journalHead;
+
+    // Paths are prefixed, so a file named "END" cannot end the reply early
+    bool wellFormed = true;
+    std::string path;
+    while (conn.readLine(line)) {
+        if (line == "END") {
+            journal.reachable = true;
+            journal.valid = wellFormed && state == "OK" && journalHead == head;
+            break;
+        }
+        if (line.rfind("P ", 0) == 0 && unescapePath(line.substr(2), path))
+            journal.dirty.insert(path);
+        else
+            wellFormed = false;
+    }
+
+    if (!journal.valid) journal.dirty.clear();
+    return journal;
+}
+
+void acknowledge(const std::string& vcsDir, uint64_t sequence,
+                 const std::string& head) {
+    ipc::Connection conn(ipc::connectUnix(socketPath(vcsDir), CLIENT_TIMEOUT_MS));
+    if (!conn.valid()) return;
+
+    std::string reply;
+    if (conn.send("RESET " + std::to_string(sequence) + " " + head + "\n"))
+        conn.readLine(reply);
+}
+
+bool stop(const std::string& vcsDir) {
+    ipc::Connection conn(ipc::connectUnix(socketPath(vcsDir), CLIENT_TIMEOUT_MS));
+    if (!conn.valid() || !conn.send("STOP\n")) return false;
+
+    std::string reply;
+    return conn.readLine(reply) && reply == "OK";
+}
+
+#ifdef __linux__
+
+namespace {
+
+    // Beyond this many distinct dirty paths a full scan is cheaper anyway
+    const size_t MAX_JOURNAL = 65536;
+
+    const uint32_t WATCH_MASK =
+        IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE |
+        IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF |
+        IN_ONLYDIR | IN_EXCL_UNLINK;
+
+    volatile std::sig_atomic_t stopRequested = 0;
+
+    void onSignal(int) {
+        stopRequested = 1;
+    }
+
+    class Daemon {
+    public:
+        Daemon(const std::string& root, const std::string& vcsDir, std::ostream& out)
+            : root(root), vcsDir(vcsDir), out(out) {}
+
+        ~Daemon() {
+            if (inotifyFd >= 0) ::close(inotifyFd);
+        }
+
+        bool start() {
+            inotifyFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (inotifyFd < 0) return false;
+            addWatches("");
+            return true;
+        }
+
+        void seed(const std::vector<std::string>& paths) {
+            head = utils::read_file(vcsDir + "/HEAD");
+            for (const auto& p : paths) record(p);
+        }
+
+        int fd() const { return inotifyFd; }
+        size_t watchCount() const { return dirs.size(); }
+
+        /**
+         * Consume every queued inotify event without blocking
+         */
+        void drain() {
+            alignas(inotify_event) char buf[64 * 1024];
+
+            while (true) {
+                ssize_t len = ::read(inotifyFd, buf, sizeof(buf));
+                if (len < 0 && errno == EINTR) continue;
+                if (len <= 0) return;
+
+                for (char* p = buf; p < buf + len; ) {
+                    auto* ev = reinterpret_cast<inotify_event*>(p);
+                    handleEvent(*ev);
+                    p += sizeof(inotify_event) + ev->len;
+                }
+            }
+        }
+
+        /**
+         * Serve one client request
+         * @return false if the client asked the daemon to stop
+         */
+        bool serve(ipc::Connection& conn) {
+            std::string line;
+            if (!conn.readLine(line)) return true;
+
+            std::istringstream iss(line);
+            std::string cmd;
+            iss >> cmd;
+
+            if (cmd == "QUERY") {
+                drain();
+                bool trusted = !overflowed && !incomplete;
+                std::ostringstream out;
+                out << (trusted ? "OK " : "OVERFLOW ") << sequence << " "
+                    << (head.empty() ? "null" : head) << "\n";
+                if (trusted) {
+                    for (const auto& entry : journal)
+                        out << "P " << escapePath(entry.first) << "\n";
+                }
+                out << "END\n";
+                conn.send(out.str());
+            }
+            else if (cmd == "RESET") {
+                uint64_t upTo = 0;
+                std::string newHead;
+                iss >> upTo >> newHead;
+
+                drain();
+                for (auto it = journal.begin(); it != journal.end(); ) {
+                    if (it->second <= upTo) it = journal.erase(it);
+                    else ++it;
+                }
+                if (overflowed && overflowAt <= upTo) overflowed = false;
+                if (!newHead.empty()) head = newHead;
+                conn.send("OK\n");
+            }
+            else if (cmd == "STOP") {
+                conn.send("OK\n");
+                return false;
+            }
+            else {
+                conn.send("ERROR unknown command\n");
+            }
+            return true;
+        }
+
+    private:
+        std::string root;
+        std::string vcsDir;
+        std::ostream& out;
+        int inotifyFd = -1;
+        std::unordered_map<int, std::string> dirs;   // watch descriptor -> relative dir
+        std::unordered_map<std::string, uint64_t> journal;
+        std::string head;
+        uint64_t sequence = 0;
+        uint64_t overflowAt = 0;
+        bool overflowed = false;
+        bool incomplete = false;    // could not watch every directory
+
+        static bool isInternal(const std::string& rel) {
+            return rel == ".vcs" || rel.rfind(".vcs/", 0) == 0;
+        }
+
+        void addWatch(const std::string& rel) {
+            std::string full = rel.empty() ? root : root + "/" + rel;
+            int wd = ::inotify_add_watch(inotifyFd, full.c_str(), WATCH_MASK);
+            if (wd < 0) {
+                if (errno == ENOSPC && !incomplete) {
+                    out << "Warning: inotify watch limit reached; "
+                                 "clients will fall back to full scans\n";
+                }
+                if (errno != ENOENT && errno != ENOTDIR) incomplete = true;
+                return;
+            }
+            // A moved directory keeps its descriptor; this updates its path
+            dirs[wd] = rel;
+        }
+
+        void addWatches(const std::string& rel) {
+            addWatch(rel);
+
+            std::string full = rel.empty() ? root : root + "/" + rel;
+            std::error_code ec;
+            std::filesystem::recursive_directory_iterator it(
+                full, std::filesystem::directory_options::skip_permission_denied, ec);
+
+            for (; !ec && it != std::filesystem::recursive_directory_iterator();
+                 it.increment(ec)) {
+                std::error_code typeEc;
+                if (!it->is_directory(typeEc) || it->is_symlink(typeEc)) continue;
+
+                std::string child = std::filesystem::relative(it->path(), root, typeEc)
+                                        .generic_string();
+                if (isInternal(child)) {
+                    it.disable_recursion_pending();
+                    continue;
+                }
+                addWatch(child);
+            }
+        }
+
+        void record(const std::string& path) {
+            if (overflowed) return;
+
+            journal[path] = ++sequence;
+            if (journal.size() > MAX_JOURNAL) {
+                overflowed = true;
+                overflowAt = sequence;
+                journal.clear();
+            }
+        }
+
+        void handleEvent(const inotify_event& ev) {
+            if (ev.mask & IN_Q_OVERFLOW) {
+                overflowed = true;
+                overflowAt = ++sequence;
+                journal.clear();
+                return;
+            }
+
+            auto dir = dirs.find(ev.wd);
+            if (dir == dirs.end()) return;
+
+            if (ev.mask & IN_IGNORED) {
+                dirs.erase(dir);
+                return;
+            }
+
+            std::string name = ev.len ? std::string(ev.name) : std::string();
+            std::string rel = dir->second;
+            if (!name.empty()) rel = rel.empty() ? name : rel + "/" + name;
+
+            if (rel.empty() || isInternal(rel)) return;
+            record(rel);
+
+            if ((ev.mask & IN_ISDIR) && (ev.mask & (IN_CREATE | IN_MOVED_TO)))
+                addWatches(rel);
+        }
+    };
+}
+
+int run(const std::string& root, const std::string& vcsDir,
+        const std::function<std::vector<std::string>()>& seed, std::ostream& out) {
+    std::string path = socketPath(vcsDir);
+
+    {
+        ipc::Connection probe(ipc::connectUnix(path, CLIENT_TIMEOUT_MS));
+        if (probe.valid()) {
+            out << "Error: watcher already running\n";
+            return 1;
+        }
+    }
+
+    Daemon daemon(root, vcsDir, out);
+    if (!daemon.start()) {
+        out << "Error: inotify unavailable\n";
+        return 1;
+    }
+
+    // Watches first, then the baseline scan: edits made during the scan
+    // are queued as events instead of being lost
+    daemon.seed(seed());
+
+    int listenFd = ipc::listenUnix(path);
+    if (listenFd < 0) {
+        out << "Error: cannot listen on " << path << "\n";
+        return 1;
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    out << "Watching " << daemon.watchCount() << " directories "
+        << "(socket: " << path << ")\n";
+    out.flush();
+
+    bool running = true;
+    while (running && !stopRequested) {
+        pollfd fds[2] = {
+            { daemon.fd(), POLLIN, 0 },
+            { listenFd, POLLIN, 0 },
+        };
+
+        int ready = ::poll(fds, 2, 500);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        if (fds[0].revents & POLLIN) daemon.drain();
+
+        if (fds[1].revents & POLLIN) {
+            ipc::Connection conn(ipc::acceptClient(listenFd));
+            if (conn.valid()) running = daemon.serve(conn);
+        }
+    }
+
+    ipc::closeSocket(listenFd);
+    ::unlink(path.c_str());
+    out << "Watcher stopped\n";
+    return 0;
+}
+
+#else
+
+int run(const std::string&, const std::string&,
+        const std::function<std::vector<std::string>()>&, std::ostream& out) {
+    out << "Error: the watcher requires Linux (inotify)\n";
+    return 1;
+}
+
+#endif
+
+}
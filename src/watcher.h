@@ -0,0 +1,66 @@
+/**
+ * LiteVCS Filesystem Watcher Header
+ *
+ * Optional background daemon that watches the working tree with inotify
+ * and keeps a journal of paths touched since the last save/checkout.
+ * diff, save and status ask it which paths may have changed instead of
+ * stat-ing every tracked file.
+ *
+ * @author Puneeth R (GHOST)
+ * @license MIT
+ */
+
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace watcher {
+
+    /**
+     * Answer to a journal query
+     */
+    struct Journal {
+        bool reachable = false;     // a daemon answered
+        bool valid = false;         // dirty set can be trusted (no overflow, same HEAD)
+        uint64_t sequence = 0;      // daemon event counter when the query was answered
+        std::unordered_set<std::string> dirty;
+
+        /**
+         * True if the path, or any directory above it, was touched
+         */
+        bool isDirty(const std::string& path) const;
+    };
+
+    /**
+     * Ask a running daemon for the dirty paths
+     * @param head Current HEAD; a journal recorded against another HEAD is invalid
+     */
+    Journal query(const std::string& vcsDir, const std::string& head);
+
+    /**
+     * Tell the daemon the working tree now matches `head` for every event
+     * up to and including `sequence`
+     */
+    void acknowledge(const std::string& vcsDir, uint64_t sequence,
+                     const std::string& head);
+
+    /**
+     * Ask a running daemon to exit
+     * @return true if a daemon was running
+     */
+    bool stop(const std::string& vcsDir);
+
+    /**
+     * Run the daemon in the foreground until stopped
+     * @param seed Called once watches are in place; returns the tracked paths
+     *             that already differ from HEAD
+     * @param out  Receives status and error messages
+     * @return Process exit code
+     */
+    int run(const std::string& root, const std::string& vcsDir,
+            const std::function<std::vector<std::string>()>& seed, std::ostream& out);
+}
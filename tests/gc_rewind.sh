@@ -0,0 +1,34 @@
+#!/bin/sh
+# gc after `go` to an older commit must keep the newer commits
+# Usage: gc_rewind.sh <path-to-vcs>
+set -e
+
+VCS="$(cd "$(dirname "$1")" && pwd)/$(basename "$1")"
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+cd "$WORK"
+
+"$VCS" init >/dev/null
+echo one > a.txt
+"$VCS" track a.txt >/dev/null
+"$VCS" save one >/dev/null
+ONE=$(cat .vcs/HEAD)
+echo two > a.txt
+"$VCS" save two >/dev/null
+TWO=$(cat .vcs/HEAD)
+
+"$VCS" go "$ONE" >/dev/null
+"$VCS" gc --prune=now >/dev/null
+
+"$VCS" go "$TWO" | grep -q "Moved to commit" || { echo "FAIL: commit two was pruned"; exit 1; }
+[ "$(cat a.txt)" = "two" ] || { echo "FAIL: wrong content after checkout"; exit 1; }
+[ "$("$VCS" history | grep -c '^commit')" -eq 2 ] || { echo "FAIL: history incomplete"; exit 1; }
+
+# A commit made on top of the rewound HEAD forks history; both tips survive
+"$VCS" go "$ONE" >/dev/null
+echo fork > a.txt
+"$VCS" save fork >/dev/null
+"$VCS" gc --prune=now >/dev/null
+"$VCS" go "$TWO" | grep -q "Moved to commit" || { echo "FAIL: tip lost after fork"; exit 1; }
+
+echo "PASS"
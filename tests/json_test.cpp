@@ -0,0 +1,81 @@
+/**
+ * Server request parsing: flat objects, escapes and what gets rejected
+ * Usage: json_test
+ *
+ * @author Puneeth R (GHOST)
+ * @license MIT
+ */
+
+#include "json.h"
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+    int failures = 0;
+
+    using Fields = std::unordered_map<std::string, std::string>;
+
+    void fail(const std::string& text, const std::string& why) {
+        std::cout << "FAIL: " << text << " - " << why << "\n";
+        failures++;
+    }
+
+    void accepts(const std::string& text, const std::string& key,
+                 const std::string& wanted) {
+        Fields fields;
+        std::string error;
+        if (!json::parseObject(text, fields, error)) fail(text, "rejected: " + error);
+        else if (fields[key] != wanted) fail(text, key + " is \"" + fields[key] + "\"");
+    }
+
+    void rejects(const std::string& text) {
+        Fields fields;
+        std::string error;
+        if (json::parseObject(text, fields, error)) fail(text, "accepted");
+        else if (error.empty()) fail(text, "rejected without an error message");
+    }
+}
+
+int main() {
+    // Plain objects; non-string scalars keep their literal text
+    accepts(R"({"op":"status","id":"1"})", "op", "status");
+    accepts(R"( { "op" : "diff" , "renames" : true } )", "renames", "true");
+    accepts(R"({"threshold":70})", "threshold", "70");
+    accepts(R"({"pruneDays":-1})", "pruneDays", "-1");
+    accepts(R"({})", "op", "");
+
+    // Escapes
+    accepts(R"({"m":"a\"b\\c\/d"})", "m", "a\"b\\c/d");
+    accepts(R"({"m":"\b\f\n\r\t"})", "m", "\b\f\n\r\t");
+    accepts(R"({"m":"\u0041\u00e9\u20AC"})", "m", "A\xC3\xA9\xE2\x82\xAC");
+
+    // Surrogate pairs decode to one 4-byte character; lone halves are refused
+    accepts(R"({"m":"\ud83d\ude00"})", "m", "\xF0\x9F\x98\x80");
+    rejects(R"({"m":"\ud83d"})");
+    rejects(R"({"m":"\ud83dx"})");
+    rejects(R"({"m":"\ud83d\u0041"})");
+    rejects(R"({"m":"\ude00"})");
+
+    // Quoting round-trips control characters
+    accepts("{\"m\":" + json::quote("tab\there\x01") + "}", "m", "tab\there\x01");
+
+    // Malformed input
+    rejects(R"({"m":"\x"})");
+    rejects(R"({"m":"\u12"})");
+    rejects(R"({"m":"open)");
+    rejects(R"({"m":"a"} extra)");
+    rejects(R"({"m" "a"})");
+    rejects(R"({"m":"a",})");
+    rejects(R"(["op"])");
+    rejects("");
+
+    // Only flat objects: nested values are refused, not flattened
+    rejects(R"({"op":{"x":1}})");
+    rejects(R"({"op":["save"]})");
+
+    if (failures) return 1;
+    std::cout << "PASS\n";
+    return 0;
+}
@@ -0,0 +1,56 @@
+/**
+ * Similarity sketches must count repeated lines
+ * Usage: similarity_test
+ *
+ * @author Puneeth R (GHOST)
+ * @license MIT
+ */
+
+#include "similarity.h"
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+    int failures = 0;
+
+    void check(bool ok, const std::string& what) {
+        if (!ok) {
+            std::cout << "FAIL: " << what << "\n";
+            failures++;
+        }
+    }
+
+    std::vector<std::string> repeat(const std::string& line, size_t times) {
+        return std::vector<std::string>(times, line);
+    }
+}
+
+int main() {
+    using namespace similarity;
+
+    // One brace against a hundred: the same distinct lines, very different files
+    double e = estimate(build(repeat("}", 1)), build(repeat("}", 100)));
+    check(e < minimumEstimate(50), "1 vs 100 repeated lines look similar (" +
+                                   std::to_string(e) + ")");
+
+    // Half the copies: true multiset Jaccard is 0.5
+    e = estimate(build(repeat("}", 50)), build(repeat("}", 100)));
+    check(std::fabs(e - 0.5) < 0.2, "50 vs 100 repeated lines estimate " +
+                                    std::to_string(e) + ", expected about 0.5");
+
+    // Order does not matter, repeats included
+    std::vector<std::string> a = { "int x;", "}", "}", "return 0;", "}" };
+    std::vector<std::string> b = { "}", "}", "}", "int x;", "return 0;" };
+    check(estimate(build(a), build(b)) == 1.0, "reordered lines differ");
+
+    // Dropping one repeated line must be visible
+    std::vector<std::string> c = { "int x;", "}", "return 0;", "}" };
+    check(estimate(build(a), build(c)) < 1.0, "dropped repeat not detected");
+
+    if (failures) return 1;
+    std::cout << "PASS\n";
+    return 0;
+}
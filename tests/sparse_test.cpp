@@ -0,0 +1,73 @@
+/**
+ * Sparse checkout patterns must match the way the readme describes
+ * Usage: sparse_test
+ *
+ * @author Puneeth R (GHOST)
+ * @license MIT
+ */
+
+#include "sparse.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+    int failures = 0;
+
+    void expect(const std::vector<std::string>& patterns, const std::string& path,
+                bool wanted) {
+        if (sparse::Matcher(patterns).matches(path) == wanted) return;
+
+        std::cout << "FAIL: " << (patterns.empty() ? "(none)" : patterns[0])
+                  << (wanted ? " should match " : " should not match ") << path << "\n";
+        failures++;
+    }
+}
+
+int main() {
+    // No patterns: the whole tree
+    expect({}, "anything/at/all.txt", true);
+    expect({ "# only a comment", "" }, "a.txt", true);
+
+    // A plain path covers itself and everything below it
+    expect({ "src/net" }, "src/net", true);
+    expect({ "src/net" }, "src/net/a.c", true);
+    expect({ "src/net" }, "src/net/deep/b.c", true);
+    expect({ "src/net" }, "src/network.c", false);
+    expect({ "src/net" }, "src/ne", false);
+    expect({ "src/net" }, "lib/src/net/a.c", false);
+    expect({ "./src/net/" }, "src/net/a.c", true);
+
+    // '*' and '?' stay within one path component
+    expect({ "docs/api-*.md" }, "docs/api-v1.md", true);
+    expect({ "docs/api-*.md" }, "docs/api-.md", true);
+    expect({ "docs/api-*.md" }, "docs/api-v1/x.md", false);
+    expect({ "docs/api-*.md" }, "docs/sub/api-v1.md", false);
+    expect({ "src/f?.txt" }, "src/f1.txt", true);
+    expect({ "src/f?.txt" }, "src/f.txt", false);
+    expect({ "src/f?.txt" }, "src/f/.txt", false);
+
+    // '**' crosses components, and "**/" can match no directory at all
+    expect({ "src/net**.c" }, "src/net.c", true);
+    expect({ "src/net**.c" }, "src/net/a/b.c", true);
+    expect({ "src/net**.c" }, "src/net/a.h", false);
+    expect({ "src/**/test.c" }, "src/test.c", true);
+    expect({ "src/**/test.c" }, "src/a/b/test.c", true);
+    expect({ "src/**/test.c" }, "lib/test.c", false);
+
+    // A pattern with no '/' matches a file or directory name at any depth
+    expect({ "*.proto" }, "api.proto", true);
+    expect({ "*.proto" }, "a/b/api.proto", true);
+    expect({ "*.proto" }, "a/proto", false);
+    expect({ "build" }, "a/build/x.o", true);
+    expect({ "build" }, "a/builder/x.o", false);
+
+    // Several patterns: any one is enough
+    expect({ "docs", "*.proto" }, "src/api.proto", true);
+    expect({ "docs", "*.proto" }, "src/api.cpp", false);
+
+    if (failures) return 1;
+    std::cout << "PASS\n";
+    return 0;
+}